@@ -0,0 +1,1857 @@
+// xdsa_bench.c
+//
+// Microbenchmarks for the xdsa primitives. Built by `make bench`, which links
+// this file against xdsa.c (compiled with `XDSA_NO_MAIN`) at -O2 or -O3.
+//
+// Every case is run for sizes 1e2, 1e3, ... up to `--max` (clamped to the
+// case's own limit) and repeated `--reps` times. Each repetition yields one
+// ns/op sample; the report shows min, p50, p90, p99 and max of those samples
+// together with ops/s at the median. Results are also written as JSON.
+//
+// Usage: ./xdsa_bench [--max N] [--reps R] [--threads T] [--scale]
+//                     [--filter NAME] [--json PATH]
+//
+// `--scale` runs the parallel cases once per thread count 1, 2, 4, ... up to
+// every online CPU instead of once with `--threads`.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "xdsa.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_MAX 1000000
+#define BENCH_LIMIT 100000000
+#define BENCH_DEFAULT_REPS 7
+#define BENCH_MAX_REPS 101
+
+#ifndef XDSA_BENCH_OPT
+#define XDSA_BENCH_OPT "unknown"
+#endif // XDSA_BENCH_OPT
+
+// Each case measures its own timed region so setup and teardown are excluded.
+// It returns elapsed nanoseconds and stores the number of operations timed.
+typedef uint64_t (*bench_fn)(size_t n, size_t *ops);
+
+struct bench_case {
+    const char *name;
+    size_t max_n; // O(n^2) and deeply recursive cases stop early
+    bench_fn fn;
+};
+
+struct bench_result {
+    const char *name;
+    size_t n;
+    size_t ops;
+    size_t reps;
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+    double ops_per_second;
+    double bytes_per_element; // 0 when the case does not report memory
+    unsigned threads;         // 0 unless the run is part of `--scale`
+    // Element buffers obtained and resized by one run of the case, setup
+    // included, from the XDSA_STATS counters; always 0 without them.
+    size_t allocations;
+    size_t reallocations;
+};
+
+// Keeps results observable so the optimizer cannot drop the timed work.
+static volatile long long bench_sink;
+
+// Cases that build a container may store the bytes it holds here; the runner
+// reports it per element.
+static size_t bench_footprint;
+
+// Thread count for the parallel cases; 0 means every online CPU.
+static unsigned bench_threads;
+
+static uint64_t bench_rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// xorshift64*: deterministic so every run sees the same inputs.
+static uint64_t bench_rand(void) {
+    bench_rng_state ^= bench_rng_state >> 12;
+    bench_rng_state ^= bench_rng_state << 25;
+    bench_rng_state ^= bench_rng_state >> 27;
+    return bench_rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static void *bench_malloc(size_t bytes) {
+    void *memory = malloc(bytes ? bytes : 1);
+    if (memory == NULL) {
+        fprintf(stderr,
+                "Failed to allocate %zu bytes in file %s on line %u within "
+                "function %s.\n",
+                bytes, __FILE__, __LINE__, __func__);
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+static int *bench_random_array(size_t n) {
+    int *array = bench_malloc(n * sizeof(*array));
+    size_t i;
+    for (i = 0; i < n; i++) {
+        array[i] = (int)(bench_rand() >> 32);
+    }
+    return array;
+}
+
+// Always holds at least one element, so that the compiler can see the
+// buffer is written before callers pass it on even when `n` is 0.
+static int *bench_sorted_array(size_t n) {
+    int *array = bench_malloc((n != 0 ? n : 1) * sizeof(*array));
+    size_t i = 0;
+    do {
+        array[i] = (int)(i * 2);
+    } while (++i < n);
+    return array;
+}
+
+// Targets for search cases: roughly half hit, half miss.
+static int *bench_search_targets(size_t n) {
+    int *targets = bench_malloc(n * sizeof(*targets));
+    size_t i;
+    for (i = 0; i < n; i++) {
+        targets[i] = (int)(bench_rand() % (2 * n));
+    }
+    return targets;
+}
+
+static int bench_compare_int(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t bench_vector_push_back(size_t n, size_t *ops) {
+    struct xdsa_vector *vector = xdsa_vector_create(0);
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_vector_push_back(vector, (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = xdsa_vector_back(vector);
+    xdsa_vector_destroy(vector);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_vector_at(size_t n, size_t *ops) {
+    struct xdsa_vector *vector = xdsa_vector_create(n);
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_vector_push_back(vector, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_vector_at(vector, (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_vector_destroy(vector);
+    *ops = n;
+    return elapsed;
+}
+
+// Reductions and searches over an `n` element vector, ns per element.
+// `vector_at` above is the element-by-element baseline for `vector_sum`.
+enum bench_simd_op {
+    BENCH_SIMD_SUM,
+    BENCH_SIMD_MINMAX,
+    BENCH_SIMD_COUNT,
+    BENCH_SIMD_FIND
+};
+
+static uint64_t bench_simd(enum xdsa_simd_level level, enum bench_simd_op op,
+                           size_t n, size_t *ops) {
+    struct xdsa_vector *vector = xdsa_vector_create(n);
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_vector_push_back(vector, (int)(bench_rand() % 1000));
+    }
+    enum xdsa_simd_level previous = xdsa_simd_level();
+    xdsa_simd_set_level(level);
+    long long result = 0;
+    int min = 0, max = 0;
+    uint64_t start = bench_now();
+    switch (op) {
+    case BENCH_SIMD_SUM:
+        result = xdsa_vector_sum(vector);
+        break;
+    case BENCH_SIMD_MINMAX:
+        xdsa_vector_minmax(vector, &min, &max);
+        result = min + max;
+        break;
+    case BENCH_SIMD_COUNT:
+        result = (long long)xdsa_vector_count_if_eq(vector, 500);
+        break;
+    case BENCH_SIMD_FIND:
+        // Absent, so the whole vector is scanned
+        result = xdsa_vector_find(vector, -1);
+        break;
+    }
+    uint64_t elapsed = bench_now() - start;
+    xdsa_simd_set_level(previous);
+    bench_sink = result;
+    xdsa_vector_destroy(vector);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_vector_sum_scalar(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_SCALAR, BENCH_SIMD_SUM, n, ops);
+}
+
+static uint64_t bench_vector_sum_sse2(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_SSE2, BENCH_SIMD_SUM, n, ops);
+}
+
+static uint64_t bench_vector_sum_avx2(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_AVX2, BENCH_SIMD_SUM, n, ops);
+}
+
+static uint64_t bench_vector_minmax_scalar(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_SCALAR, BENCH_SIMD_MINMAX, n, ops);
+}
+
+static uint64_t bench_vector_minmax(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_AVX2, BENCH_SIMD_MINMAX, n, ops);
+}
+
+static uint64_t bench_vector_count_if_eq_scalar(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_SCALAR, BENCH_SIMD_COUNT, n, ops);
+}
+
+static uint64_t bench_vector_count_if_eq(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_AVX2, BENCH_SIMD_COUNT, n, ops);
+}
+
+static uint64_t bench_vector_find_scalar(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_SCALAR, BENCH_SIMD_FIND, n, ops);
+}
+
+static uint64_t bench_vector_find(size_t n, size_t *ops) {
+    return bench_simd(XDSA_SIMD_AVX2, BENCH_SIMD_FIND, n, ops);
+}
+
+// Loads `n` values with one call: a single memcpy and at most one realloc.
+static uint64_t bench_vector_append(size_t n, size_t *ops) {
+    int *source = bench_sorted_array(n);
+    struct xdsa_vector *vector = xdsa_vector_create(0);
+    uint64_t start = bench_now();
+    xdsa_vector_append(vector, source, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = xdsa_vector_back(vector);
+    xdsa_vector_destroy(vector);
+    free(source);
+    *ops = n;
+    return elapsed;
+}
+
+// `vector_push_back` with page-granular growth, which switches to `mremap`
+// once the buffer is large.
+static uint64_t bench_vector_push_back_pages(size_t n, size_t *ops) {
+    struct xdsa_vector *vector = xdsa_vector_create(0);
+    size_t i;
+    xdsa_vector_set_growth(vector, XDSA_VECTOR_GROWTH_PAGES);
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_vector_push_back(vector, (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = xdsa_vector_back(vector);
+    xdsa_vector_destroy(vector);
+    *ops = n;
+    return elapsed;
+}
+
+// Process start-up: a saved vector is mapped and read once, against
+// parsing the same values back from text. ns per element, open included.
+#define BENCH_VECTOR_PATH "xdsa_bench_vector.bin"
+
+static uint64_t bench_vector_open_mmap(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    struct xdsa_vector *source = xdsa_vector_create(0);
+    xdsa_vector_append(source, array, n);
+    if (!xdsa_vector_save(source, BENCH_VECTOR_PATH)) {
+        fprintf(stderr, "Failed to save %s.\n", BENCH_VECTOR_PATH);
+        exit(EXIT_FAILURE);
+    }
+    xdsa_vector_destroy(source);
+    free(array);
+    long long sum = 0;
+    uint64_t start = bench_now();
+    struct xdsa_vector *vector =
+        xdsa_vector_open_mmap(BENCH_VECTOR_PATH, XDSA_VECTOR_MAP_READ_ONLY);
+    if (vector == NULL) {
+        fprintf(stderr, "Failed to map %s.\n", BENCH_VECTOR_PATH);
+        exit(EXIT_FAILURE);
+    }
+    int size = xdsa_vector_size(vector), i;
+    for (i = 0; i < size; i++) {
+        sum += xdsa_vector_at(vector, i);
+    }
+    xdsa_vector_destroy(vector);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    remove(BENCH_VECTOR_PATH);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_vector_parse_text(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    char *text = bench_malloc(XDSA_FORMAT_INT_ARRAY_BYTES(n));
+    xdsa_format_int_array(text, array, n, ' ');
+    free(array);
+    long long sum = 0;
+    uint64_t start = bench_now();
+    struct xdsa_vector *vector = xdsa_vector_create(0);
+    char *cursor = text, *end;
+    for (;;) {
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor) {
+            break;
+        }
+        xdsa_vector_push_back(vector, (int)value);
+        cursor = end;
+    }
+    int size = xdsa_vector_size(vector), i;
+    for (i = 0; i < size; i++) {
+        sum += xdsa_vector_at(vector, i);
+    }
+    xdsa_vector_destroy(vector);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    free(text);
+    *ops = n;
+    return elapsed;
+}
+
+XDSA_VECTOR_DEFINE(bench_id_vector, unsigned long long)
+
+// Same workload as `vector_push_back` through a typed, header-inline vector.
+static uint64_t bench_typed_vector_push_back(size_t n, size_t *ops) {
+    struct bench_id_vector *vector = bench_id_vector_create(0);
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        bench_id_vector_push_back(vector, i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)bench_id_vector_back(vector);
+    bench_id_vector_destroy(vector);
+    *ops = n;
+    return elapsed;
+}
+
+// Many short vectors of `BENCH_SMALL_ITEMS` ints, the common case: `heap`
+// allocates the struct and a buffer and regrows it once, `inline` keeps the
+// elements inside a 16-element small vector and `single_block` puts them
+// right after the struct. Both of the latter take one allocation per vector
+// and skip the pointer hop to a separate buffer when scanning. Built with
+// XDSA_STATS, the allocs/op column shows the buffer allocations and resizes
+// the heap layout pays per element and the others avoid.
+#define BENCH_SMALL_ITEMS 12
+
+enum bench_small_layout {
+    BENCH_SMALL_HEAP,
+    BENCH_SMALL_INLINE,
+    BENCH_SMALL_SINGLE_BLOCK
+};
+
+XDSA_VECTOR_DEFINE(bench_int_vector, int)
+XDSA_SMALL_VECTOR_DEFINE(bench_small_vector, int, 16)
+
+static void *bench_small_create(enum bench_small_layout layout, int seed) {
+    int i;
+    if (layout == BENCH_SMALL_INLINE) {
+        struct bench_small_vector *vector = bench_small_vector_create(0);
+        for (i = 0; i < BENCH_SMALL_ITEMS; i++) {
+            bench_small_vector_push_back(vector, seed + i);
+        }
+        return vector;
+    }
+    struct bench_int_vector *vector =
+        layout == BENCH_SMALL_HEAP ? bench_int_vector_create(8)
+                                   : bench_int_vector_create_single_block(16);
+    for (i = 0; i < BENCH_SMALL_ITEMS; i++) {
+        bench_int_vector_push_back(vector, seed + i);
+    }
+    return vector;
+}
+
+static long long bench_small_sum(enum bench_small_layout layout,
+                                 void *vector) {
+    long long sum = 0;
+    size_t i;
+    if (layout == BENCH_SMALL_INLINE) {
+        struct bench_small_vector *small = vector;
+        for (i = 0; i < small->size; i++) {
+            sum += small->array[i];
+        }
+    } else {
+        struct bench_int_vector *plain = vector;
+        for (i = 0; i < plain->size; i++) {
+            sum += plain->array[i];
+        }
+    }
+    return sum;
+}
+
+static void bench_small_destroy(enum bench_small_layout layout, void *vector) {
+    if (layout == BENCH_SMALL_INLINE) {
+        bench_small_vector_destroy(vector);
+    } else {
+        bench_int_vector_destroy(vector);
+    }
+}
+
+// Bytes one vector holds, struct included.
+static size_t bench_small_footprint(enum bench_small_layout layout,
+                                    void *vector) {
+    if (layout == BENCH_SMALL_INLINE) {
+        struct bench_small_vector *small = vector;
+        return sizeof(*small) + (small->array != small->inline_elements
+                                     ? small->capacity * sizeof(int)
+                                     : 0);
+    }
+    struct bench_int_vector *plain = vector;
+    return plain->storage.block_bytes +
+           (plain->array != plain->storage.embedded
+                ? plain->capacity * sizeof(int)
+                : 0);
+}
+
+// Creates, fills and destroys `n / BENCH_SMALL_ITEMS` vectors; ns per
+// element.
+static uint64_t bench_small_lifecycle(enum bench_small_layout layout, size_t n,
+                                      size_t *ops) {
+    size_t count = n / BENCH_SMALL_ITEMS + 1;
+    long long sum = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < count; i++) {
+        void *vector = bench_small_create(layout, (int)i);
+        sum += bench_small_sum(layout, vector);
+        bench_small_destroy(layout, vector);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    *ops = count * BENCH_SMALL_ITEMS;
+    return elapsed;
+}
+
+// Sums every element of `n / BENCH_SMALL_ITEMS` live vectors visited in
+// random order, so each vector is a cache miss; ns per element.
+static uint64_t bench_small_scan(enum bench_small_layout layout, size_t n,
+                                 size_t *ops) {
+    size_t count = n / BENCH_SMALL_ITEMS + 1;
+    void **vectors = bench_malloc(count * sizeof(*vectors));
+    size_t footprint = 0;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        vectors[i] = bench_small_create(layout, (int)i);
+        footprint += bench_small_footprint(layout, vectors[i]);
+    }
+    bench_footprint = footprint;
+    for (i = count - 1; i > 0; i--) {
+        size_t j = (size_t)(bench_rand() % (i + 1));
+        void *swap = vectors[i];
+        vectors[i] = vectors[j];
+        vectors[j] = swap;
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < count; i++) {
+        sum += bench_small_sum(layout, vectors[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    for (i = 0; i < count; i++) {
+        bench_small_destroy(layout, vectors[i]);
+    }
+    free(vectors);
+    *ops = count * BENCH_SMALL_ITEMS;
+    return elapsed;
+}
+
+static uint64_t bench_small_heap(size_t n, size_t *ops) {
+    return bench_small_lifecycle(BENCH_SMALL_HEAP, n, ops);
+}
+
+static uint64_t bench_small_inline(size_t n, size_t *ops) {
+    return bench_small_lifecycle(BENCH_SMALL_INLINE, n, ops);
+}
+
+static uint64_t bench_small_single_block(size_t n, size_t *ops) {
+    return bench_small_lifecycle(BENCH_SMALL_SINGLE_BLOCK, n, ops);
+}
+
+static uint64_t bench_small_scan_heap(size_t n, size_t *ops) {
+    return bench_small_scan(BENCH_SMALL_HEAP, n, ops);
+}
+
+static uint64_t bench_small_scan_inline(size_t n, size_t *ops) {
+    return bench_small_scan(BENCH_SMALL_INLINE, n, ops);
+}
+
+static uint64_t bench_small_scan_single_block(size_t n, size_t *ops) {
+    return bench_small_scan(BENCH_SMALL_SINGLE_BLOCK, n, ops);
+}
+
+static uint64_t bench_sll_push_front(size_t n, size_t *ops) {
+    struct xdsa_linked_list *list = xdsa_sll_create();
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_sll_push_front(list, (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = xdsa_sll_front(list);
+    xdsa_sll_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_sll_pop_front(size_t n, size_t *ops) {
+    struct xdsa_linked_list *list = xdsa_sll_create();
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_sll_push_front(list, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_sll_pop_front(list);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_sll_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+// Queue workload: a window of 64 items with one push_back and one pop_front
+// per operation, which recycles nodes through the list's pool.
+static uint64_t bench_sll_queue(size_t n, size_t *ops) {
+    struct xdsa_linked_list *list = xdsa_sll_create();
+    size_t i;
+    for (i = 0; i < 64; i++) {
+        xdsa_sll_push_back(list, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_sll_push_back(list, (int)i);
+        sum += xdsa_sll_pop_front(list);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_sll_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+// Walks an `n` element list, one dependent load per element.
+static uint64_t bench_sll_traverse(size_t n, size_t *ops) {
+    struct xdsa_linked_list *list = xdsa_sll_create();
+    const struct xdsa_list_node *node;
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_sll_push_back(list, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (node = xdsa_sll_head(list); node != NULL;
+         node = xdsa_list_node_next(node)) {
+        sum += xdsa_list_node_data(node);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    bench_footprint = xdsa_list_node_pool_stats(xdsa_sll_pool(list)).slab_bytes;
+    xdsa_sll_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+// Teardown of an `n` element list, which is O(slabs) rather than O(n).
+static uint64_t bench_sll_destroy(size_t n, size_t *ops) {
+    struct xdsa_linked_list *list = xdsa_sll_create();
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_sll_push_front(list, (int)i);
+    }
+    uint64_t start = bench_now();
+    xdsa_sll_destroy(list);
+    uint64_t elapsed = bench_now() - start;
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_ull_push_back(size_t n, size_t *ops) {
+    struct xdsa_unrolled_list *list = xdsa_ull_create();
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_ull_push_back(list, (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = xdsa_ull_back(list);
+    xdsa_ull_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_ull_pop_front(size_t n, size_t *ops) {
+    struct xdsa_unrolled_list *list = xdsa_ull_create();
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_ull_push_back(list, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_ull_pop_front(list);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_ull_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_ull_queue(size_t n, size_t *ops) {
+    struct xdsa_unrolled_list *list = xdsa_ull_create();
+    size_t i;
+    for (i = 0; i < 64; i++) {
+        xdsa_ull_push_back(list, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_ull_push_back(list, (int)i);
+        sum += xdsa_ull_pop_front(list);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_ull_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_deque_queue(size_t n, size_t *ops) {
+    struct xdsa_deque *deque = xdsa_deque_create(0);
+    size_t i;
+    for (i = 0; i < 64; i++) {
+        xdsa_deque_push_back(deque, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_deque_push_back(deque, (int)i);
+        sum += xdsa_deque_pop_front(deque);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_deque_destroy(deque);
+    *ops = n;
+    return elapsed;
+}
+
+// Stack use at the front, growing through every doubling.
+static uint64_t bench_deque_push_front(size_t n, size_t *ops) {
+    struct xdsa_deque *deque = xdsa_deque_create(0);
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_deque_push_front(deque, (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)xdsa_deque_size(deque);
+    xdsa_deque_destroy(deque);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_ull_traverse(size_t n, size_t *ops) {
+    struct xdsa_unrolled_list *list = xdsa_ull_create();
+    struct xdsa_ull_iterator it;
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_ull_push_back(list, (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (it = xdsa_ull_begin(list); xdsa_ull_iterator_valid(&it);
+         xdsa_ull_iterator_next_chunk(&it)) {
+        size_t length;
+        const int *span = xdsa_ull_iterator_span(&it, &length);
+        for (i = 0; i < length; i++) {
+            sum += span[i];
+        }
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    bench_footprint = xdsa_ull_memory_usage(list);
+    xdsa_ull_destroy(list);
+    *ops = n;
+    return elapsed;
+}
+
+// Queue throughput: producer threads hand `n` items in total to as many
+// consumer threads, against the mutex-wrapped list they replace. ns per
+// item, wall clock from the first push to the last pop.
+enum bench_queue_kind { BENCH_QUEUE_SPSC, BENCH_QUEUE_MPMC, BENCH_QUEUE_MUTEX };
+
+#define BENCH_QUEUE_CAPACITY 1024
+#define BENCH_QUEUE_BATCH 32
+
+struct bench_queue_shared {
+    enum bench_queue_kind kind;
+    size_t batch; // items per push/pop call; 1 for the mutex baseline
+    struct xdsa_spsc_queue *spsc;
+    struct xdsa_mpmc_queue *mpmc;
+    struct xdsa_linked_list *list;
+    pthread_mutex_t mutex;
+};
+
+struct bench_queue_task {
+    struct bench_queue_shared *shared;
+    size_t count; // items this thread pushes or pops
+    long long sum;
+};
+
+static size_t bench_queue_push(struct bench_queue_shared *shared,
+                               const int *items, size_t count) {
+    switch (shared->kind) {
+    case BENCH_QUEUE_SPSC:
+        return xdsa_spsc_queue_push_bulk(shared->spsc, items, count);
+    case BENCH_QUEUE_MPMC:
+        return xdsa_mpmc_queue_push_bulk(shared->mpmc, items, count);
+    default:
+        pthread_mutex_lock(&shared->mutex);
+        xdsa_sll_push_back(shared->list, items[0]);
+        pthread_mutex_unlock(&shared->mutex);
+        return 1;
+    }
+}
+
+static size_t bench_queue_pop(struct bench_queue_shared *shared, int *items,
+                              size_t count) {
+    size_t popped = 0;
+    switch (shared->kind) {
+    case BENCH_QUEUE_SPSC:
+        return xdsa_spsc_queue_pop_bulk(shared->spsc, items, count);
+    case BENCH_QUEUE_MPMC:
+        return xdsa_mpmc_queue_pop_bulk(shared->mpmc, items, count);
+    default:
+        pthread_mutex_lock(&shared->mutex);
+        if (!xdsa_sll_empty(shared->list)) {
+            items[0] = xdsa_sll_pop_front(shared->list);
+            popped = 1;
+        }
+        pthread_mutex_unlock(&shared->mutex);
+        return popped;
+    }
+}
+
+static void *bench_queue_producer(void *argument) {
+    struct bench_queue_task *task = argument;
+    int items[BENCH_QUEUE_BATCH];
+    size_t done = 0, i;
+    for (i = 0; i < BENCH_QUEUE_BATCH; i++) {
+        items[i] = (int)i;
+    }
+    while (done < task->count) {
+        size_t count = task->count - done;
+        if (count > task->shared->batch) {
+            count = task->shared->batch;
+        }
+        size_t pushed = bench_queue_push(task->shared, items, count);
+        done += pushed;
+        if (pushed == 0) {
+            sched_yield(); // full; let a consumer run on a busy machine
+        }
+    }
+    return NULL;
+}
+
+static void *bench_queue_consumer(void *argument) {
+    struct bench_queue_task *task = argument;
+    int items[BENCH_QUEUE_BATCH];
+    size_t done = 0, i;
+    while (done < task->count) {
+        size_t count = task->count - done;
+        if (count > task->shared->batch) {
+            count = task->shared->batch;
+        }
+        size_t popped = bench_queue_pop(task->shared, items, count);
+        for (i = 0; i < popped; i++) {
+            task->sum += items[i];
+        }
+        done += popped;
+        if (popped == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Producer/consumer pairs: one for SPSC, otherwise half of `--threads`
+// (or of the online CPUs) but at least two, so MPMC always has producers and
+// consumers contending with each other even on small machines.
+static size_t bench_queue_pairs(enum bench_queue_kind kind) {
+    if (kind == BENCH_QUEUE_SPSC) {
+        return 1;
+    }
+    long threads = bench_threads != 0 ? (long)bench_threads
+                                       : sysconf(_SC_NPROCESSORS_ONLN);
+    return threads >= 4 ? (size_t)threads / 2 : 2;
+}
+
+static uint64_t bench_queue(size_t n, size_t *ops, enum bench_queue_kind kind,
+                            size_t batch) {
+    struct bench_queue_shared shared;
+    size_t pairs = bench_queue_pairs(kind), i;
+    pthread_t *threads = bench_malloc(2 * pairs * sizeof(*threads));
+    struct bench_queue_task *tasks = bench_malloc(2 * pairs * sizeof(*tasks));
+    shared.kind = kind;
+    shared.batch = batch;
+    shared.spsc = xdsa_spsc_queue_create(BENCH_QUEUE_CAPACITY);
+    shared.mpmc = xdsa_mpmc_queue_create(BENCH_QUEUE_CAPACITY);
+    shared.list = xdsa_sll_create();
+    pthread_mutex_init(&shared.mutex, NULL);
+    for (i = 0; i < 2 * pairs; i++) {
+        size_t pair = i % pairs;
+        tasks[i].shared = &shared;
+        tasks[i].count = n / pairs + (pair < n % pairs);
+        tasks[i].sum = 0;
+    }
+    uint64_t start = bench_now();
+    for (i = 0; i < 2 * pairs; i++) {
+        if (pthread_create(&threads[i], NULL,
+                           i < pairs ? bench_queue_producer
+                                     : bench_queue_consumer,
+                           &tasks[i]) != 0) {
+            fprintf(stderr, "Failed to start a queue benchmark thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    long long sum = 0;
+    for (i = 0; i < 2 * pairs; i++) {
+        pthread_join(threads[i], NULL);
+        sum += tasks[i].sum;
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    pthread_mutex_destroy(&shared.mutex);
+    xdsa_sll_destroy(shared.list);
+    xdsa_mpmc_queue_destroy(shared.mpmc);
+    xdsa_spsc_queue_destroy(shared.spsc);
+    free(tasks);
+    free(threads);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_spsc_queue(size_t n, size_t *ops) {
+    return bench_queue(n, ops, BENCH_QUEUE_SPSC, 1);
+}
+
+static uint64_t bench_spsc_queue_bulk(size_t n, size_t *ops) {
+    return bench_queue(n, ops, BENCH_QUEUE_SPSC, BENCH_QUEUE_BATCH);
+}
+
+static uint64_t bench_mpmc_queue(size_t n, size_t *ops) {
+    return bench_queue(n, ops, BENCH_QUEUE_MPMC, 1);
+}
+
+static uint64_t bench_mpmc_queue_bulk(size_t n, size_t *ops) {
+    return bench_queue(n, ops, BENCH_QUEUE_MPMC, BENCH_QUEUE_BATCH);
+}
+
+static uint64_t bench_mutex_sll_queue(size_t n, size_t *ops) {
+    return bench_queue(n, ops, BENCH_QUEUE_MUTEX, 1);
+}
+
+// Random keys, so the map grows through every doubling.
+static uint64_t bench_hashmap_put(size_t n, size_t *ops) {
+    int *keys = bench_random_array(n);
+    struct xdsa_hashmap *map = xdsa_hashmap_create(0);
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_hashmap_put(map, keys[i], (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)xdsa_hashmap_size(map);
+    xdsa_hashmap_destroy(map);
+    free(keys);
+    *ops = n;
+    return elapsed;
+}
+
+// Roughly half the lookups hit, like the search cases.
+static uint64_t bench_hashmap_get(size_t n, size_t *ops) {
+    int *keys = bench_sorted_array(n);
+    int *targets = bench_search_targets(n);
+    struct xdsa_hashmap *map = xdsa_hashmap_create(n);
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_hashmap_put(map, keys[i], (int)i);
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        int value = 0;
+        sum += xdsa_hashmap_get(map, targets[i], &value) ? value : -1;
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_hashmap_destroy(map);
+    free(targets);
+    free(keys);
+    *ops = n;
+    return elapsed;
+}
+
+// Steady state: each operation removes one key and inserts another.
+static uint64_t bench_hashmap_churn(size_t n, size_t *ops) {
+    int *keys = bench_random_array(2 * n);
+    struct xdsa_hashmap *map = xdsa_hashmap_create(n);
+    size_t i;
+    for (i = 0; i < n; i++) {
+        xdsa_hashmap_put(map, keys[i], (int)i);
+    }
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_hashmap_remove(map, keys[i]);
+        xdsa_hashmap_put(map, keys[n + i], (int)i);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)xdsa_hashmap_size(map);
+    xdsa_hashmap_destroy(map);
+    free(keys);
+    *ops = n;
+    return elapsed;
+}
+
+// Push everything, then pop everything; ns per element for both.
+static uint64_t bench_heap_push_pop(size_t n, size_t *ops, unsigned arity) {
+    int *array = bench_random_array(n);
+    struct xdsa_heap *heap = xdsa_heap_create(XDSA_HEAP_MIN, arity);
+    long long sum = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        xdsa_heap_push(heap, array[i]);
+    }
+    for (i = 0; i < n; i++) {
+        sum += xdsa_heap_pop(heap);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_heap_destroy(heap);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_heap2_push_pop(size_t n, size_t *ops) {
+    return bench_heap_push_pop(n, ops, 2);
+}
+
+static uint64_t bench_heap4_push_pop(size_t n, size_t *ops) {
+    return bench_heap_push_pop(n, ops, 4);
+}
+
+static uint64_t bench_heap_heapify(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    struct xdsa_heap *heap = xdsa_heap_create(XDSA_HEAP_MIN, 4);
+    uint64_t start = bench_now();
+    xdsa_heap_heapify(heap, array, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = xdsa_heap_top(heap);
+    xdsa_heap_destroy(heap);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// The 100 smallest of n, against sorting everything in the sort case.
+static uint64_t bench_smallest_k(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    int out[100];
+    uint64_t start = bench_now();
+    size_t count = xdsa_smallest_k(array, n, 100, out);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = out[count / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// Short-lived containers per request, a few elements each: torn down one by
+// one on malloc, or dropped with a single reset on an arena. Reports ns per
+// request.
+#define BENCH_REQUEST_ITEMS 16
+
+static void bench_request(const struct xdsa_allocator *allocator, int seed,
+                          bool destroy) {
+    struct xdsa_vector *vector =
+        xdsa_vector_create_with_allocator(1, allocator);
+    struct xdsa_linked_list *list = xdsa_sll_create_with_allocator(allocator);
+    struct xdsa_hashmap *map =
+        xdsa_hashmap_create_with_allocator(BENCH_REQUEST_ITEMS, allocator);
+    for (int i = 0; i < BENCH_REQUEST_ITEMS; i++) {
+        xdsa_vector_push_back(vector, seed + i);
+        xdsa_sll_push_back(list, seed - i);
+        xdsa_hashmap_put(map, seed + i, i);
+    }
+    bench_sink = xdsa_vector_at(vector, BENCH_REQUEST_ITEMS / 2) +
+                 xdsa_sll_front(list) + (int)xdsa_hashmap_size(map);
+    if (destroy) {
+        xdsa_vector_destroy(vector);
+        xdsa_sll_destroy(list);
+        xdsa_hashmap_destroy(map);
+    }
+}
+
+static uint64_t bench_request_malloc(size_t n, size_t *ops) {
+    uint64_t start = bench_now();
+    for (size_t i = 0; i < n; i++) {
+        bench_request(NULL, (int)i, true);
+    }
+    uint64_t elapsed = bench_now() - start;
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_request_arena(size_t n, size_t *ops) {
+    struct xdsa_arena *arena = xdsa_arena_create(0);
+    const struct xdsa_allocator *allocator = xdsa_arena_allocator(arena);
+    uint64_t start = bench_now();
+    for (size_t i = 0; i < n; i++) {
+        bench_request(allocator, (int)i, false);
+        xdsa_arena_reset(arena);
+    }
+    uint64_t elapsed = bench_now() - start;
+    xdsa_arena_destroy(arena);
+    *ops = n;
+    return elapsed;
+}
+
+// Sorting cases report ns per element.
+static uint64_t bench_insertion_sort(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    xdsa_insertion_sort(array, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_sort(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    xdsa_sort(array, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// Already sorted input, which pdqsort finishes in linear time.
+static uint64_t bench_sort_sorted(size_t n, size_t *ops) {
+    int *array = bench_sorted_array(n);
+    uint64_t start = bench_now();
+    xdsa_sort(array, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// The scratch buffer is reused across repetitions, as a service would.
+static struct xdsa_radix_scratch *bench_radix_scratch;
+
+static uint64_t bench_radix_sort(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    if (bench_radix_scratch == NULL) {
+        bench_radix_scratch = xdsa_radix_scratch_create();
+    }
+    uint64_t start = bench_now();
+    xdsa_radix_sort_with_scratch(bench_radix_scratch, array, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_parallel_sort(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    xdsa_parallel_sort(array, n, bench_threads);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// Four distinct keys: every splitter repeats.
+static uint64_t bench_parallel_sort_few_unique(size_t n, size_t *ops) {
+    int *array = bench_malloc(n * sizeof(*array));
+    size_t i;
+    for (i = 0; i < n; i++) {
+        array[i] = (int)(bench_rand() % 4);
+    }
+    uint64_t start = bench_now();
+    xdsa_parallel_sort(array, n, bench_threads);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// Like the radix scratch, the pool outlives a case; it is rebuilt when
+// `--scale` changes the thread count.
+static struct xdsa_pool *bench_pool;
+static unsigned bench_pool_threads;
+
+static struct xdsa_pool *bench_get_pool(void) {
+    if (bench_pool == NULL || bench_pool_threads != bench_threads) {
+        xdsa_pool_destroy(bench_pool);
+        bench_pool = xdsa_pool_create(bench_threads);
+        bench_pool_threads = bench_threads;
+    }
+    return bench_pool;
+}
+
+static void bench_parallel_for_body(void *context, int *chunk, size_t count,
+                                    size_t offset) {
+    size_t i;
+    (void)context;
+    (void)offset;
+    for (i = 0; i < count; i++) {
+        chunk[i] = chunk[i] * 3 + 1;
+    }
+}
+
+static uint64_t bench_parallel_for(size_t n, size_t *ops) {
+    struct xdsa_pool *pool = bench_get_pool();
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    xdsa_parallel_for(pool, array, n, bench_parallel_for_body, NULL);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_parallel_sum(size_t n, size_t *ops) {
+    struct xdsa_pool *pool = bench_get_pool();
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    bench_sink = xdsa_parallel_sum(pool, array, n);
+    uint64_t elapsed = bench_now() - start;
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_parallel_inclusive_scan(size_t n, size_t *ops) {
+    struct xdsa_pool *pool = bench_get_pool();
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    xdsa_parallel_inclusive_scan(pool, array, array, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n - 1];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_libc_qsort(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    uint64_t start = bench_now();
+    qsort(array, n, sizeof(*array), bench_compare_int);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = array[n / 2];
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_binary_search(size_t n, size_t *ops) {
+    int *array = bench_sorted_array(n);
+    int *targets = bench_search_targets(n);
+    long long hits = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        hits += xdsa_binary_search(array, (int)n, targets[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = hits;
+    free(targets);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_libc_bsearch(size_t n, size_t *ops) {
+    int *array = bench_sorted_array(n);
+    int *targets = bench_search_targets(n);
+    long long hits = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        hits += bsearch(&targets[i], array, n, sizeof(*array),
+                        bench_compare_int) != NULL;
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = hits;
+    free(targets);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_binary_search_batch(size_t n, size_t *ops) {
+    int *array = bench_sorted_array(n);
+    int *targets = bench_search_targets(n);
+    int *out = bench_malloc(n * sizeof(*out));
+    long long hits = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    xdsa_binary_search_batch(array, (int)n, targets, out, n);
+    uint64_t elapsed = bench_now() - start;
+    for (i = 0; i < n; i++) {
+        hits += out[i];
+    }
+    bench_sink = hits;
+    free(out);
+    free(targets);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_lower_bound(size_t n, size_t *ops) {
+    int *array = bench_sorted_array(n);
+    int *targets = bench_search_targets(n);
+    size_t sum = 0, i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_lower_bound(array, n, targets[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)sum;
+    free(targets);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// Index construction is a one-off cost and stays outside the timed region.
+static uint64_t bench_search_index(size_t n, size_t *ops,
+                                   enum xdsa_search_layout layout) {
+    int *array = bench_sorted_array(n);
+    int *targets = bench_search_targets(n);
+    struct xdsa_search_index *index =
+        xdsa_search_index_create(array, n, layout);
+    size_t sum = 0, i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_search_index_lower_bound(index, targets[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)sum;
+    xdsa_search_index_destroy(index);
+    free(targets);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_eytzinger_search(size_t n, size_t *ops) {
+    return bench_search_index(n, ops, XDSA_SEARCH_LAYOUT_EYTZINGER);
+}
+
+static uint64_t bench_btree_search(size_t n, size_t *ops) {
+    return bench_search_index(n, ops, XDSA_SEARCH_LAYOUT_BTREE);
+}
+
+// Fibonacci cases time whole calls with `n` as the index. Small indices are
+// repeated so each sample covers at least ~1e6 loop steps.
+static size_t bench_fibonacci_calls(size_t n) {
+    return n >= 1000000 ? 1 : 1000000 / n;
+}
+
+// The memoized variants reuse one memo and invalidate it before every call,
+// otherwise each call after the first is a single memo hit. Past
+// XDSA_FIBONACCI_MAX_EXACT they defer to fast doubling, so they are timed
+// at that index and run at the smallest size only.
+static size_t bench_fibonacci_memo_index(size_t n) {
+    return n < XDSA_FIBONACCI_MAX_EXACT ? n : XDSA_FIBONACCI_MAX_EXACT;
+}
+
+static uint64_t bench_top_down_fibonacci(size_t n, size_t *ops) {
+    n = bench_fibonacci_memo_index(n);
+    size_t calls = bench_fibonacci_calls(n);
+    struct xdsa_memo *memo = xdsa_memo_create(n + 1);
+    unsigned long long sum = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < calls; i++) {
+        xdsa_memo_invalidate(memo);
+        sum += xdsa_top_down_fibonacci_memo(memo, n);
+    }
+    uint64_t elapsed = bench_now() - start;
+    xdsa_memo_destroy(memo);
+    bench_sink = (long long)sum;
+    *ops = calls;
+    return elapsed;
+}
+
+static uint64_t bench_bottom_up_fibonacci(size_t n, size_t *ops) {
+    n = bench_fibonacci_memo_index(n);
+    size_t calls = bench_fibonacci_calls(n);
+    struct xdsa_memo *memo = xdsa_memo_create(n + 1);
+    unsigned long long sum = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < calls; i++) {
+        xdsa_memo_invalidate(memo);
+        sum += xdsa_bottom_up_fibonacci_memo(memo, n);
+    }
+    uint64_t elapsed = bench_now() - start;
+    xdsa_memo_destroy(memo);
+    bench_sink = (long long)sum;
+    *ops = calls;
+    return elapsed;
+}
+
+static uint64_t bench_optimized_bottom_up_fibonacci(size_t n, size_t *ops) {
+    size_t calls = bench_fibonacci_calls(n);
+    unsigned long long sum = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < calls; i++) {
+        // Vary the argument so the call is not hoisted out of the loop.
+        sum += xdsa_optimized_bottom_up_fibonacci(n - (i & 1));
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)sum;
+    *ops = calls;
+    return elapsed;
+}
+
+static uint64_t bench_fast_doubling_fibonacci(size_t n, size_t *ops) {
+    size_t calls = bench_fibonacci_calls(n);
+    unsigned long long sum = 0;
+    size_t i;
+    uint64_t start = bench_now();
+    for (i = 0; i < calls; i++) {
+        sum += xdsa_fast_doubling_fibonacci(n - (i & 1));
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)sum;
+    *ops = calls;
+    return elapsed;
+}
+
+// Exact results; F(1e6) has about 694k bits.
+static uint64_t bench_bigint_fibonacci(size_t n, size_t *ops) {
+    size_t calls = n >= 1000 ? 1 : 1000 / n;
+    size_t bits = 0, i;
+    uint64_t start = bench_now();
+    for (i = 0; i < calls; i++) {
+        struct xdsa_bigint *result = xdsa_bigint_fibonacci(n);
+        bits += xdsa_bigint_bits(result);
+        xdsa_bigint_destroy(result);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)bits;
+    *ops = calls;
+    return elapsed;
+}
+
+static uint64_t bench_mod(size_t n, size_t *ops) {
+    long long *a = bench_malloc(n * sizeof(*a));
+    long long *b = bench_malloc(n * sizeof(*b));
+    size_t i;
+    for (i = 0; i < n; i++) {
+        a[i] = (long long)bench_rand();
+        b[i] = (long long)(bench_rand() % 1000000) - 500000;
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_mod(a[i], b[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    free(b);
+    free(a);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_format_int_array(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    char *text = bench_malloc(XDSA_FORMAT_INT_ARRAY_BYTES(n));
+    uint64_t start = bench_now();
+    size_t length = xdsa_format_int_array(text, array, n, '\n');
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)length + text[length / 2];
+    free(text);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+// The same output through one `sprintf` per element.
+static uint64_t bench_libc_sprintf(size_t n, size_t *ops) {
+    int *array = bench_random_array(n);
+    char *text = bench_malloc(XDSA_FORMAT_INT_ARRAY_BYTES(n));
+    size_t length = 0, i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        length += (size_t)sprintf(text + length, "%d\n", array[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)length + text[length / 2];
+    free(text);
+    free(array);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_format_hex(size_t n, size_t *ops) {
+    char buffer[XDSA_FORMAT_HEX_MAX];
+    size_t length = 0, i;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        length += xdsa_format_hex(buffer, bench_rand(), 0);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = (long long)length + buffer[0];
+    *ops = n;
+    return elapsed;
+}
+
+// A fixed divisor, as in hashing or ring buffers; `mod` above varies it.
+#define BENCH_MOD_DIVISOR (-1000003LL)
+
+static uint64_t bench_mod_fixed(size_t n, size_t *ops) {
+    long long *a = bench_malloc(n * sizeof(*a));
+    size_t i;
+    for (i = 0; i < n; i++) {
+        a[i] = (long long)bench_rand();
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_mod(a[i], BENCH_MOD_DIVISOR);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    free(a);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_mod_fast(size_t n, size_t *ops) {
+    long long *a = bench_malloc(n * sizeof(*a));
+    struct xdsa_modulus *modulus = xdsa_modulus_create(BENCH_MOD_DIVISOR);
+    size_t i;
+    for (i = 0; i < n; i++) {
+        a[i] = (long long)bench_rand();
+    }
+    long long sum = 0;
+    uint64_t start = bench_now();
+    for (i = 0; i < n; i++) {
+        sum += xdsa_mod_fast(modulus, a[i]);
+    }
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = sum;
+    xdsa_modulus_destroy(modulus);
+    free(a);
+    *ops = n;
+    return elapsed;
+}
+
+static uint64_t bench_mod_fast_batch(size_t n, size_t *ops) {
+    int *a = bench_random_array(n);
+    struct xdsa_modulus *modulus = xdsa_modulus_create(BENCH_MOD_DIVISOR);
+    uint64_t start = bench_now();
+    xdsa_mod_fast_batch(modulus, a, a, n);
+    uint64_t elapsed = bench_now() - start;
+    bench_sink = a[n / 2];
+    xdsa_modulus_destroy(modulus);
+    free(a);
+    *ops = n;
+    return elapsed;
+}
+
+static const struct bench_case bench_cases[] = {
+    {"vector_push_back", BENCH_LIMIT, bench_vector_push_back},
+    {"vector_at", BENCH_LIMIT, bench_vector_at},
+    {"vector_sum_scalar", BENCH_LIMIT, bench_vector_sum_scalar},
+    {"vector_sum_sse2", BENCH_LIMIT, bench_vector_sum_sse2},
+    {"vector_sum_avx2", BENCH_LIMIT, bench_vector_sum_avx2},
+    {"vector_minmax_scalar", BENCH_LIMIT, bench_vector_minmax_scalar},
+    {"vector_minmax", BENCH_LIMIT, bench_vector_minmax},
+    {"vector_count_if_eq_scalar", BENCH_LIMIT, bench_vector_count_if_eq_scalar},
+    {"vector_count_if_eq", BENCH_LIMIT, bench_vector_count_if_eq},
+    {"vector_find_scalar", BENCH_LIMIT, bench_vector_find_scalar},
+    {"vector_find", BENCH_LIMIT, bench_vector_find},
+    {"vector_append", BENCH_LIMIT, bench_vector_append},
+    {"vector_push_back_pages", BENCH_LIMIT, bench_vector_push_back_pages},
+    {"typed_vector_push_back", BENCH_LIMIT, bench_typed_vector_push_back},
+    {"small_vector_heap", BENCH_LIMIT, bench_small_heap},
+    {"small_vector_inline", BENCH_LIMIT, bench_small_inline},
+    {"small_vector_single_block", BENCH_LIMIT, bench_small_single_block},
+    {"small_vector_scan_heap", BENCH_LIMIT, bench_small_scan_heap},
+    {"small_vector_scan_inline", BENCH_LIMIT, bench_small_scan_inline},
+    {"small_vector_scan_single_block", BENCH_LIMIT,
+     bench_small_scan_single_block},
+    {"vector_open_mmap", BENCH_LIMIT, bench_vector_open_mmap},
+    {"vector_parse_text", BENCH_LIMIT, bench_vector_parse_text},
+    {"sll_push_front", BENCH_LIMIT, bench_sll_push_front},
+    {"sll_pop_front", BENCH_LIMIT, bench_sll_pop_front},
+    {"sll_queue", BENCH_LIMIT, bench_sll_queue},
+    {"sll_destroy", BENCH_LIMIT, bench_sll_destroy},
+    {"sll_traverse", BENCH_LIMIT, bench_sll_traverse},
+    {"ull_push_back", BENCH_LIMIT, bench_ull_push_back},
+    {"ull_pop_front", BENCH_LIMIT, bench_ull_pop_front},
+    {"ull_queue", BENCH_LIMIT, bench_ull_queue},
+    {"ull_traverse", BENCH_LIMIT, bench_ull_traverse},
+    {"deque_queue", BENCH_LIMIT, bench_deque_queue},
+    {"deque_push_front", BENCH_LIMIT, bench_deque_push_front},
+    {"spsc_queue", BENCH_LIMIT, bench_spsc_queue},
+    {"spsc_queue_bulk", BENCH_LIMIT, bench_spsc_queue_bulk},
+    {"mpmc_queue", BENCH_LIMIT, bench_mpmc_queue},
+    {"mpmc_queue_bulk", BENCH_LIMIT, bench_mpmc_queue_bulk},
+    {"mutex_sll_queue", BENCH_LIMIT, bench_mutex_sll_queue},
+    {"hashmap_put", BENCH_LIMIT, bench_hashmap_put},
+    {"hashmap_get", BENCH_LIMIT, bench_hashmap_get},
+    {"hashmap_churn", BENCH_LIMIT, bench_hashmap_churn},
+    {"heap2_push_pop", BENCH_LIMIT, bench_heap2_push_pop},
+    {"heap4_push_pop", BENCH_LIMIT, bench_heap4_push_pop},
+    {"heap_heapify", BENCH_LIMIT, bench_heap_heapify},
+    {"smallest_k", BENCH_LIMIT, bench_smallest_k},
+    {"request_malloc", BENCH_LIMIT, bench_request_malloc},
+    {"request_arena", BENCH_LIMIT, bench_request_arena},
+    {"insertion_sort", 10000, bench_insertion_sort},
+    {"sort", BENCH_LIMIT, bench_sort},
+    {"sort_sorted", BENCH_LIMIT, bench_sort_sorted},
+    {"radix_sort", BENCH_LIMIT, bench_radix_sort},
+    {"parallel_sort", BENCH_LIMIT, bench_parallel_sort},
+    {"parallel_sort_few_unique", BENCH_LIMIT, bench_parallel_sort_few_unique},
+    {"parallel_for", BENCH_LIMIT, bench_parallel_for},
+    {"parallel_sum", BENCH_LIMIT, bench_parallel_sum},
+    {"parallel_inclusive_scan", BENCH_LIMIT, bench_parallel_inclusive_scan},
+    {"libc_qsort", BENCH_LIMIT, bench_libc_qsort},
+    {"binary_search", BENCH_LIMIT, bench_binary_search},
+    {"binary_search_batch", BENCH_LIMIT, bench_binary_search_batch},
+    {"libc_bsearch", BENCH_LIMIT, bench_libc_bsearch},
+    {"lower_bound", BENCH_LIMIT, bench_lower_bound},
+    {"eytzinger_search", BENCH_LIMIT, bench_eytzinger_search},
+    {"btree_search", BENCH_LIMIT, bench_btree_search},
+    // Top-down recursion is as deep as its index.
+    {"top_down_fibonacci", 100, bench_top_down_fibonacci},
+    {"bottom_up_fibonacci", 100, bench_bottom_up_fibonacci},
+    {"optimized_bottom_up_fibonacci", BENCH_LIMIT,
+     bench_optimized_bottom_up_fibonacci},
+    {"fast_doubling_fibonacci", BENCH_LIMIT, bench_fast_doubling_fibonacci},
+    {"bigint_fibonacci", 1000000, bench_bigint_fibonacci},
+    {"mod", BENCH_LIMIT, bench_mod},
+    {"mod_fixed", BENCH_LIMIT, bench_mod_fixed},
+    {"mod_fast", BENCH_LIMIT, bench_mod_fast},
+    {"mod_fast_batch", BENCH_LIMIT, bench_mod_fast_batch},
+    {"format_int_array", BENCH_LIMIT, bench_format_int_array},
+    {"libc_sprintf", BENCH_LIMIT, bench_libc_sprintf},
+    {"format_hex", BENCH_LIMIT, bench_format_hex},
+};
+
+static int bench_compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile over sorted samples.
+static double bench_percentile(const double *sorted, size_t count,
+                               double percentile) {
+    size_t rank = (size_t)(percentile / 100.0 * (double)count + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+    if (rank > count) {
+        rank = count;
+    }
+    return sorted[rank - 1];
+}
+
+static struct bench_result bench_run(const struct bench_case *bench, size_t n,
+                                     size_t reps) {
+    double samples[BENCH_MAX_REPS];
+    struct bench_result result;
+    size_t ops = 0;
+    size_t i;
+
+    // Warm-up run populates caches and the allocator's free lists. Vectors
+    // and lists add their counters to the totals when destroyed, so the
+    // difference covers every container the run built.
+    bench_footprint = 0;
+#ifdef XDSA_STATS
+    struct xdsa_stats before = xdsa_stats_snapshot();
+#endif // XDSA_STATS
+    bench->fn(n, &ops);
+#ifdef XDSA_STATS
+    struct xdsa_stats after = xdsa_stats_snapshot();
+    result.allocations = after.vector.allocations + after.list.allocations -
+                         before.vector.allocations - before.list.allocations;
+    result.reallocations = after.vector.reallocations -
+                           before.vector.reallocations;
+#else
+    result.allocations = 0;
+    result.reallocations = 0;
+#endif // XDSA_STATS
+    for (i = 0; i < reps; i++) {
+        uint64_t elapsed = bench->fn(n, &ops);
+        samples[i] = (double)elapsed / (double)ops;
+    }
+    qsort(samples, reps, sizeof(*samples), bench_compare_double);
+
+    result.name = bench->name;
+    result.n = n;
+    result.ops = ops;
+    result.reps = reps;
+    result.min = samples[0];
+    result.p50 = bench_percentile(samples, reps, 50.0);
+    result.p90 = bench_percentile(samples, reps, 90.0);
+    result.p99 = bench_percentile(samples, reps, 99.0);
+    result.max = samples[reps - 1];
+    result.ops_per_second = result.p50 > 0.0 ? 1e9 / result.p50 : 0.0;
+    result.bytes_per_element = (double)bench_footprint / (double)n;
+    result.threads = 0;
+    return result;
+}
+
+static void bench_print_header(void) {
+    printf("%-32s %10s %10s %10s %10s %10s %10s %14s %8s", "benchmark", "n",
+           "min ns/op", "p50 ns/op", "p90 ns/op", "p99 ns/op", "max ns/op",
+           "ops/s", "B/elem");
+#ifdef XDSA_STATS
+    printf(" %10s", "allocs/op");
+#endif // XDSA_STATS
+    printf("\n");
+}
+
+static void bench_print_result(const struct bench_result *result) {
+    char label[64];
+    if (result->threads != 0) {
+        snprintf(label, sizeof(label), "%s/%ut", result->name,
+                 result->threads);
+    } else {
+        snprintf(label, sizeof(label), "%s", result->name);
+    }
+    printf("%-32s %10zu %10.2f %10.2f %10.2f %10.2f %10.2f %14.0f", label,
+           result->n, result->min, result->p50, result->p90, result->p99,
+           result->max, result->ops_per_second);
+#ifdef XDSA_STATS
+    // Keep the column aligned when there is no footprint to show
+    if (result->bytes_per_element > 0.0) {
+        printf(" %8.2f", result->bytes_per_element);
+    } else {
+        printf(" %8s", "");
+    }
+    printf(" %10.3f",
+           (double)(result->allocations + result->reallocations) /
+               (double)(result->ops != 0 ? result->ops : 1));
+#else
+    if (result->bytes_per_element > 0.0) {
+        printf(" %8.2f", result->bytes_per_element);
+    }
+#endif // XDSA_STATS
+    printf("\n");
+}
+
+static void bench_write_json(FILE *file, const struct bench_result *results,
+                             size_t count, size_t reps) {
+    size_t i;
+    fprintf(file, "{\n");
+    fprintf(file, "  \"optimization\": \"%s\",\n", XDSA_BENCH_OPT);
+#ifdef __VERSION__
+    fprintf(file, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif // __VERSION__
+    fprintf(file, "  \"repetitions\": %zu,\n", reps);
+    fprintf(file, "  \"threads\": %u,\n", bench_threads);
+    fprintf(file, "  \"results\": [\n");
+    for (i = 0; i < count; i++) {
+        const struct bench_result *r = &results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"n\": %zu, \"ops\": %zu, "
+                "\"ns_per_op\": {\"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+                "\"p99\": %.3f, \"max\": %.3f}, \"ops_per_second\": %.1f",
+                r->name, r->n, r->ops, r->min, r->p50, r->p90, r->p99, r->max,
+                r->ops_per_second);
+        if (r->bytes_per_element > 0.0) {
+            fprintf(file, ", \"bytes_per_element\": %.3f",
+                    r->bytes_per_element);
+        }
+        if (r->threads != 0) {
+            fprintf(file, ", \"threads\": %u", r->threads);
+        }
+#ifdef XDSA_STATS
+        fprintf(file, ", \"allocations\": %zu, \"reallocations\": %zu",
+                r->allocations, r->reallocations);
+#endif // XDSA_STATS
+        fprintf(file, "}%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+static void bench_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--max N] [--reps R] [--threads T] [--scale] "
+            "[--filter NAME] [--json PATH]\n"
+            "  --max N        largest input size, 100 <= N <= 1e8 "
+            "(default 1e6)\n"
+            "  --reps R       timed repetitions per size, 1 <= R <= %d "
+            "(default %d)\n"
+            "  --threads T    threads for parallel cases (default 0: all "
+            "CPUs)\n"
+            "  --scale        run parallel cases on 1, 2, 4, ... all CPUs\n"
+            "  --filter NAME  only run benchmarks whose name contains NAME\n"
+            "  --json PATH    write machine-readable results to PATH\n",
+            program, BENCH_MAX_REPS, BENCH_DEFAULT_REPS);
+}
+
+int main(int argc, char **argv) {
+    size_t max_n = BENCH_DEFAULT_MAX;
+    size_t reps = BENCH_DEFAULT_REPS;
+    const char *filter = NULL;
+    const char *json_path = NULL;
+    bool scale = false;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            // strtod so that "1e8" is accepted
+            max_n = (size_t)strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            bench_threads = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--scale") == 0) {
+            scale = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            bench_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (max_n < 100 || max_n > BENCH_LIMIT || reps < 1 ||
+        reps > BENCH_MAX_REPS) {
+        bench_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Thread counts for `--scale`: powers of two below the CPU count, then
+    // the CPU count itself.
+    unsigned scale_threads[64];
+    size_t scale_count = 0;
+    if (scale) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        unsigned t;
+        for (t = 1; t < (unsigned)(cpus > 1 ? cpus : 1) && scale_count < 63;
+             t *= 2) {
+            scale_threads[scale_count++] = t;
+        }
+        scale_threads[scale_count++] = cpus > 1 ? (unsigned)cpus : 1;
+    }
+
+    size_t case_count = sizeof(bench_cases) / sizeof(bench_cases[0]);
+    // At most 7 sizes (1e2 .. 1e8) per case and thread count.
+    size_t runs_per_size = scale_count > 0 ? scale_count : 1;
+    struct bench_result *results =
+        bench_malloc(case_count * 7 * runs_per_size * sizeof(*results));
+    const unsigned threads = bench_threads;
+    size_t result_count = 0;
+    size_t c;
+
+    printf("xdsa benchmarks (%s, %zu reps, %u threads)\n", XDSA_BENCH_OPT, reps,
+           bench_threads);
+    bench_print_header();
+    for (c = 0; c < case_count; c++) {
+        const struct bench_case *bench = &bench_cases[c];
+        size_t n;
+        if (filter != NULL && strstr(bench->name, filter) == NULL) {
+            continue;
+        }
+        bool scaled = scale && strncmp(bench->name, "parallel_", 9) == 0;
+        size_t t;
+        for (t = 0; t < (scaled ? scale_count : 1); t++) {
+            if (scaled) {
+                bench_threads = scale_threads[t];
+            }
+            for (n = 100; n <= max_n && n <= bench->max_n; n *= 10) {
+                results[result_count] = bench_run(bench, n, reps);
+                results[result_count].threads = scaled ? bench_threads : 0;
+                bench_print_result(&results[result_count]);
+                fflush(stdout);
+                result_count++;
+            }
+        }
+        bench_threads = threads;
+    }
+
+    if (json_path != NULL) {
+        FILE *file = fopen(json_path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Failed to open %s for writing.\n", json_path);
+            free(results);
+            return EXIT_FAILURE;
+        }
+        bench_write_json(file, results, result_count, reps);
+        fclose(file);
+        printf("Wrote %zu results to %s\n", result_count, json_path);
+    }
+
+    if (bench_radix_scratch != NULL) {
+        xdsa_radix_scratch_destroy(bench_radix_scratch);
+    }
+    xdsa_pool_destroy(bench_pool);
+    free(results);
+    return EXIT_SUCCESS;
+}
@@ -7,7 +7,6 @@
 extern "C" {
 #endif // __cplusplus
 
-// TODO: Add benchmarkings
 // TODO: Add documentation and examples
 
 #include <assert.h> //assert
@@ -15,49 +14,1254 @@ extern "C" {
 #include <limits.h>
 #include <stdarg.h>
 #include <stdbool.h> //true, false, bool
+#include <stdint.h>  //uint32_t, uint64_t
 #include <stdio.h> //Includes the standard I/O library for functions like `printf`.
 #include <stdlib.h> //Includes the standard library for functions like `malloc`, `free`, and `realloc`.
 #include <string.h> //Includes the string manipulation library for functions like `memcpy`.
 #include <time.h> //time
 
-// FIX: REFACTOR
-extern struct xdsa_vector *xdsa_vector_create(size_t size);
-extern void xdsa_vector_destroy(struct xdsa_vector *vector);
+// Pluggable memory source for containers.
+//
+// Every container has a `*_create_with_allocator` variant that takes its
+// memory, the container struct included, from `allocator` and keeps the
+// pointer for later growth and destruction; the plain `*_create` functions
+// pass NULL, which means `malloc`, `realloc` and `free`. `reallocate` and
+// `deallocate` get the block's current size so size-tracking allocators
+// need no per-block header. A NULL result is an allocation failure and is
+// reported like any other: the process exits.
+//
+// Deliberately without one: the SPSC/MPMC queues and the thread pool, which
+// are long-lived, shared across threads and allocate from several of them,
+// while the arena is single-threaded; and per-call algorithm state (memo
+// tables, bigints, the search index, radix scratch), which callers size once
+// and reuse rather than build per request.
+struct xdsa_allocator {
+    void *(*allocate)(void *context, size_t bytes);
+    void *(*reallocate)(void *context, void *pointer, size_t old_bytes,
+                        size_t new_bytes);
+    void (*deallocate)(void *context, void *pointer, size_t bytes);
+    void *context;
+};
+
+// `malloc`, `realloc` and `free` as an allocator.
+extern const struct xdsa_allocator xdsa_default_allocator;
+
+// Dispatch through `allocator`, or the default one when it is NULL. These
+// return NULL on failure and leave reporting to the caller.
+extern void *xdsa_allocate(const struct xdsa_allocator *allocator,
+                           size_t bytes);
+extern void *xdsa_reallocate(const struct xdsa_allocator *allocator,
+                             void *pointer, size_t old_bytes,
+                             size_t new_bytes);
+extern void xdsa_deallocate(const struct xdsa_allocator *allocator,
+                            void *pointer, size_t bytes);
+
+// Bump-pointer arena, e.g. one per request.
+//
+// Allocations are carved in order out of large blocks. `xdsa_arena_reset`
+// rewinds to the first block in O(1), which frees every container built on
+// the arena at once (do not touch or destroy them afterwards) and keeps the
+// blocks for the next round. Freeing or growing the most recent allocation
+// happens in place; other frees are no-ops until the reset. Not thread-safe.
+#define XDSA_ARENA_ALIGNMENT 16
+#define XDSA_ARENA_DEFAULT_BLOCK ((size_t)64 * 1024)
+
+struct xdsa_arena;
+
+// `block_bytes` is the size of each block, 0 for the default; larger
+// allocations get a block of their own.
+extern struct xdsa_arena *xdsa_arena_create(size_t block_bytes);
+extern void xdsa_arena_destroy(struct xdsa_arena *arena);
+extern void xdsa_arena_reset(struct xdsa_arena *arena);
+// Bytes handed out since the last reset, alignment padding included.
+extern size_t xdsa_arena_used(const struct xdsa_arena *arena);
+// Bytes held in blocks.
+extern size_t xdsa_arena_reserved(const struct xdsa_arena *arena);
+extern const struct xdsa_allocator *
+xdsa_arena_allocator(struct xdsa_arena *arena);
+
+// Type-generic vector.
+//
+// `XDSA_VECTOR_DEFINE(name, T)` generates `struct name` holding contiguous `T`
+// elements and `static inline` functions `name_create`, `name_destroy`,
+// `name_size`, `name_capacity`, `name_empty`, `name_data`, `name_clear`,
+// `name_reserve`, `name_push_back`, `name_pop_back`, `name_at`, `name_front`,
+// `name_back`, `name_append`, `name_insert_range`, `name_erase_range`,
+// `name_resize_uninitialized`, `name_shrink_to_fit` and `name_set_growth`.
+// Accessors assert that the vector is non-empty or that the index is in range
+// instead of returning a sentinel, so any `T` works.
+//
+// `XDSA_VECTOR_FUNCTIONS(prefix, name, T)` generates the functions only, with
+// names starting with `prefix`, for a struct that already has the members in
+// `XDSA_VECTOR_FIELDS(T)`. The `int` API below is one such instantiation.
+//
+// Short vectors can avoid the separate element buffer:
+// - `name_create_single_block(capacity)` allocates the struct and room for
+//   `capacity` elements as one block; `_with_allocator` takes it from an
+//   allocator.
+// - `XDSA_SMALL_VECTOR_DEFINE(name, T, N)` generates a vector that stores up
+//   to `N` elements inside the struct itself, and `name_init` and
+//   `name_deinit` for one that lives on the stack or inside another struct.
+// Both move the elements to the heap on overflow, and back when
+// `shrink_to_fit` makes them fit again. The embedded elements are addressed
+// through the struct, so such a vector must not be copied by value.
+//
+// Example:
+//     XDSA_VECTOR_DEFINE(id_vector, unsigned long long)
+//     struct id_vector *ids = id_vector_create(0);
+//     id_vector_push_back(ids, 42);
+//     id_vector_destroy(ids);
+
+// How a vector picks its next capacity when it runs out of room.
+enum xdsa_vector_growth {
+    XDSA_VECTOR_GROWTH_DOUBLE, // capacity * 2 (default)
+    XDSA_VECTOR_GROWTH_HALF,   // capacity * 1.5, less slack
+    // capacity * 1.5 rounded up to whole pages; once the buffer reaches
+    // `XDSA_VECTOR_MAP_THRESHOLD` bytes it moves to an anonymous mapping that
+    // grows with `mremap` (Linux), so the kernel remaps instead of copying.
+    XDSA_VECTOR_GROWTH_PAGES
+};
+
+#define XDSA_VECTOR_MAP_THRESHOLD ((size_t)1 << 20)
+
+// Instrumentation counters, compiled in only with `-DXDSA_STATS`. Define it
+// for the library and for every file that includes this header, since it
+// changes struct layouts. Without it the counters do not exist, the hooks in
+// the vector macros expand to nothing and the stats functions report zeros.
+//
+// Every vector and list counts its own events. `xdsa_stats_snapshot` returns
+// process-wide totals per container kind: `live_bytes` and `peak_bytes`
+// follow allocations as they happen (the peak of everything held at once),
+// while the other counters are added when a container is destroyed, because
+// vector element operations are counted inline without any shared state.
+struct xdsa_container_stats {
+    size_t allocations;   // buffers (vector) or nodes (list) obtained
+    size_t reallocations; // buffer resizes
+    size_t bytes_moved;   // bytes copied by resizes, inserts and erases
+    size_t live_bytes;    // element storage held now
+    size_t peak_bytes;    // high-water mark of `live_bytes`
+    size_t operations;    // elements pushed, popped, inserted or erased
+};
+
+struct xdsa_stats {
+    struct xdsa_container_stats vector;
+    struct xdsa_container_stats list;
+};
+
+#ifdef XDSA_STATS
+#define XDSA_STATS_CLEAR(stats) memset(&(stats), 0, sizeof(stats))
+#define XDSA_STATS_ADD(stats, counter, amount) ((stats).counter += (amount))
+#else
+#define XDSA_STATS_CLEAR(stats) ((void)0)
+#define XDSA_STATS_ADD(stats, counter, amount) ((void)0)
+#endif // XDSA_STATS
+
+extern struct xdsa_stats xdsa_stats_snapshot(void);
+// Zeroes the process-wide counters; `live_bytes` is kept and becomes the new
+// `peak_bytes`.
+extern void xdsa_stats_reset(void);
+// Writes `stats` as one JSON object; returns the `fprintf` result.
+extern int xdsa_stats_print_json(FILE *stream, const struct xdsa_stats *stats);
+
+// How `xdsa_vector_open_mmap` maps a saved vector.
+enum xdsa_vector_map_mode {
+    // The file is opened read-only and never changes. Writes, including
+    // pushes into spare capacity, go to private copies of the touched pages;
+    // growing the vector moves the elements to the heap.
+    XDSA_VECTOR_MAP_READ_ONLY,
+    // Private: writes stay in this process and never reach the file; growth
+    // moves to the heap as above.
+    XDSA_VECTOR_MAP_COPY_ON_WRITE,
+    // Shared: writes go to the file, and growth extends it with `ftruncate`
+    // and remaps.
+    XDSA_VECTOR_MAP_READ_WRITE
+};
+
+struct xdsa_vector_storage {
+    enum xdsa_vector_growth growth;
+    bool mapped; // `array` is an anonymous `mmap` region, not a heap block
+    // Descriptor of the file `array` is mapped from, -1 for memory-backed
+    // vectors. The mapping starts with the file header, right before `array`.
+    int file;
+    enum xdsa_vector_map_mode map_mode;
+    // Source of `array` and of the vector struct; NULL for the default, the
+    // only one that grows large buffers with `mremap`.
+    const struct xdsa_allocator *allocator;
+    // Element room inside the vector's own allocation, NULL if there is none.
+    // `array` points here until the elements outgrow it.
+    void *embedded;
+    size_t embedded_bytes;
+    size_t block_bytes; // the vector's own allocation
+#ifdef XDSA_STATS
+    struct xdsa_container_stats stats;
+#endif // XDSA_STATS
+};
+
+// Out-of-line storage management shared by every vector instantiation.
+extern size_t xdsa_vector_storage_next_capacity(
+    const struct xdsa_vector_storage *storage, size_t capacity, size_t minimum,
+    size_t element_size);
+extern void *xdsa_vector_storage_resize(struct xdsa_vector_storage *storage,
+                                        void *array, size_t old_bytes,
+                                        size_t new_bytes);
+extern void xdsa_vector_storage_release(struct xdsa_vector_storage *storage,
+                                        void *array, size_t bytes);
+extern struct xdsa_container_stats
+xdsa_vector_storage_stats(const struct xdsa_vector_storage *storage);
+// Makes `bytes` at `buffer`, which the vector's own allocation holds, the
+// initial element buffer.
+extern void *xdsa_vector_storage_embed(struct xdsa_vector_storage *storage,
+                                       void *buffer, size_t bytes);
+// A copy of `bytes` at `source` from the storage's allocator, for sources
+// that an operation is about to overwrite.
+extern void *xdsa_vector_storage_copy(struct xdsa_vector_storage *storage,
+                                      const void *source, size_t bytes);
+
+static inline void
+xdsa_vector_storage_init(struct xdsa_vector_storage *storage,
+                         const struct xdsa_allocator *allocator,
+                         size_t block_bytes) {
+    storage->growth = XDSA_VECTOR_GROWTH_DOUBLE;
+    storage->mapped = false;
+    storage->file = -1;
+    storage->map_mode = XDSA_VECTOR_MAP_READ_ONLY;
+    storage->allocator = allocator;
+    storage->embedded = NULL;
+    storage->embedded_bytes = 0;
+    storage->block_bytes = block_bytes;
+    XDSA_STATS_CLEAR(storage->stats);
+}
+
+// Bytes for `count` elements, and `size + count` elements. Both exit like an
+// allocation failure when the result does not fit in a `size_t`.
+static inline size_t xdsa_vector_storage_bytes(size_t count,
+                                               size_t element_size) {
+    if (count > SIZE_MAX / element_size) {
+        fprintf(stderr,
+                "Failed to allocate %zu elements in file %s on line %u within "
+                "function %s.\n",
+                count, __FILE__, __LINE__, __func__);
+        exit(EXIT_FAILURE);
+    }
+    return count * element_size;
+}
+
+static inline size_t xdsa_vector_storage_extend(size_t size, size_t count) {
+    if (count > SIZE_MAX - size) {
+        fprintf(stderr,
+                "Failed to allocate %zu more elements in file %s on line %u "
+                "within function %s.\n",
+                count, __FILE__, __LINE__, __func__);
+        exit(EXIT_FAILURE);
+    }
+    return size + count;
+}
+
+// Whether `pointer` lies within the `bytes` at `array`. Compared as integers
+// because ordering unrelated pointers is undefined.
+static inline bool xdsa_vector_storage_holds(const void *array, size_t bytes,
+                                             const void *pointer) {
+    uintptr_t begin = (uintptr_t)array;
+    uintptr_t address = (uintptr_t)pointer;
+    return array != NULL && address >= begin && address - begin < bytes;
+}
+
+// Single-block vectors put the elements at this offset from the struct.
+#define XDSA_VECTOR_BLOCK_ALIGNMENT 16
+#define XDSA_VECTOR_BLOCK_HEADER(bytes)                                        \
+    (((bytes) + XDSA_VECTOR_BLOCK_ALIGNMENT - 1) &                             \
+     ~(size_t)(XDSA_VECTOR_BLOCK_ALIGNMENT - 1))
+
+#define XDSA_VECTOR_FIELDS(T)                                                  \
+    T *array;                                                                  \
+    size_t size;                                                               \
+    size_t capacity;                                                           \
+    struct xdsa_vector_storage storage;
+
+#define XDSA_VECTOR_STRUCT(name, T)                                            \
+    struct name {                                                              \
+        XDSA_VECTOR_FIELDS(T)                                                  \
+    }
+
+#define XDSA_VECTOR_FUNCTIONS(prefix, name, T)                                 \
+    static inline struct name *prefix##_create_with_allocator(                 \
+        size_t capacity, const struct xdsa_allocator *allocator) {             \
+        struct name *vector = xdsa_allocate(allocator, sizeof(*vector));       \
+        if (vector == NULL) {                                                  \
+            fprintf(stderr,                                                    \
+                    "Failed to allocate %zu bytes in file %s on line %u "      \
+                    "within function %s.\n",                                   \
+                    sizeof(*vector), __FILE__, __LINE__, __func__);            \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+        vector->size = 0;                                                      \
+        vector->capacity = capacity;                                           \
+        xdsa_vector_storage_init(&vector->storage, allocator,                  \
+                                 sizeof(*vector));                             \
+        vector->array = xdsa_vector_storage_resize(                            \
+            &vector->storage, NULL, 0,                                         \
+            xdsa_vector_storage_bytes(capacity, sizeof(*vector->array)));      \
+        return vector;                                                         \
+    }                                                                          \
+                                                                               \
+    static inline struct name *prefix##_create(size_t capacity) {              \
+        return prefix##_create_with_allocator(capacity, NULL);                 \
+    }                                                                          \
+                                                                               \
+    /* One allocation for the struct and `capacity` elements. */               \
+    static inline struct name *prefix##_create_single_block_with_allocator(    \
+        size_t capacity, const struct xdsa_allocator *allocator) {             \
+        size_t header = XDSA_VECTOR_BLOCK_HEADER(sizeof(struct name));         \
+        size_t bytes = capacity * sizeof(T);                                   \
+        struct name *vector = NULL;                                            \
+        if (capacity <= (SIZE_MAX - header) / sizeof(T)) {                     \
+            vector = xdsa_allocate(allocator, header + bytes);                 \
+        }                                                                      \
+        if (vector == NULL) {                                                  \
+            fprintf(stderr,                                                    \
+                    "Failed to allocate %zu elements in file %s on line "      \
+                    "%u within function %s.\n",                                \
+                    capacity, __FILE__, __LINE__, __func__);                   \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+        vector->size = 0;                                                      \
+        vector->capacity = capacity;                                           \
+        xdsa_vector_storage_init(&vector->storage, allocator, header + bytes); \
+        vector->array = xdsa_vector_storage_embed(                             \
+            &vector->storage, (unsigned char *)vector + header, bytes);        \
+        return vector;                                                         \
+    }                                                                          \
+                                                                               \
+    static inline struct name *prefix##_create_single_block(                   \
+        size_t capacity) {                                                     \
+        return prefix##_create_single_block_with_allocator(capacity, NULL);    \
+    }                                                                          \
+                                                                               \
+    XDSA_VECTOR_OPERATIONS(prefix, name, T)
+
+// Everything but the constructors, shared with the small vector.
+#define XDSA_VECTOR_OPERATIONS(prefix, name, T)                                \
+    static inline void prefix##_destroy(struct name *vector) {                 \
+        const struct xdsa_allocator *allocator = vector->storage.allocator;    \
+        size_t block_bytes = vector->storage.block_bytes;                      \
+        xdsa_vector_storage_release(                                           \
+            &vector->storage, vector->array,                                   \
+            vector->capacity * sizeof(*vector->array));                        \
+        xdsa_deallocate(allocator, vector, block_bytes);                       \
+    }                                                                          \
+                                                                               \
+    static inline size_t prefix##_size(const struct name *vector) {            \
+        return vector->size;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline size_t prefix##_capacity(const struct name *vector) {        \
+        return vector->capacity;                                               \
+    }                                                                          \
+                                                                               \
+    static inline bool prefix##_empty(const struct name *vector) {             \
+        return vector->size == 0;                                              \
+    }                                                                          \
+                                                                               \
+    static inline T *prefix##_data(struct name *vector) {                      \
+        return vector->array;                                                  \
+    }                                                                          \
+                                                                               \
+    /* O(1): elements are forgotten, not overwritten. */                       \
+    static inline void prefix##_clear(struct name *vector) {                   \
+        vector->size = 0;                                                      \
+    }                                                                          \
+                                                                               \
+    static inline void prefix##_set_growth(struct name *vector,                \
+                                           enum xdsa_vector_growth growth) {   \
+        vector->storage.growth = growth;                                       \
+    }                                                                          \
+                                                                               \
+    /* Grows to exactly `capacity` elements; never shrinks. */                 \
+    static inline void prefix##_reserve(struct name *vector,                   \
+                                        size_t capacity) {                     \
+        if (capacity > vector->capacity) {                                     \
+            vector->array = xdsa_vector_storage_resize(                        \
+                &vector->storage, vector->array,                               \
+                vector->capacity * sizeof(*vector->array),                     \
+                xdsa_vector_storage_bytes(capacity, sizeof(*vector->array)));  \
+            vector->capacity = capacity;                                       \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* Slow path: one reallocation big enough for `minimum` elements. */       \
+    static inline void prefix##_grow(struct name *vector, size_t minimum) {    \
+        prefix##_reserve(vector, xdsa_vector_storage_next_capacity(            \
+                                     &vector->storage, vector->capacity,       \
+                                     minimum, sizeof(*vector->array)));        \
+    }                                                                          \
+                                                                               \
+    /* Elements that fit the embedded room move back into all of it. */        \
+    static inline void prefix##_shrink_to_fit(struct name *vector) {           \
+        size_t capacity = vector->size;                                        \
+        if (vector->storage.embedded != NULL &&                                \
+            capacity * sizeof(T) <= vector->storage.embedded_bytes) {          \
+            capacity = vector->storage.embedded_bytes / sizeof(T);             \
+        }                                                                      \
+        if (vector->capacity != capacity) {                                    \
+            vector->array = xdsa_vector_storage_resize(                        \
+                &vector->storage, vector->array,                               \
+                vector->capacity * sizeof(*vector->array),                     \
+                capacity * sizeof(*vector->array));                            \
+            vector->capacity = capacity;                                       \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static inline void prefix##_push_back(struct name *vector, T data) {       \
+        if (vector->size == vector->capacity) {                                \
+            prefix##_grow(vector, vector->size + 1);                           \
+        }                                                                      \
+        XDSA_STATS_ADD(vector->storage.stats, operations, 1);                  \
+        vector->array[vector->size++] = data;                                  \
+    }                                                                          \
+                                                                               \
+    static inline T prefix##_pop_back(struct name *vector) {                   \
+        assert(vector->size != 0);                                             \
+        XDSA_STATS_ADD(vector->storage.stats, operations, 1);                  \
+        return vector->array[--vector->size];                                  \
+    }                                                                          \
+                                                                               \
+    static inline T prefix##_at(const struct name *vector, size_t index) {     \
+        assert(index < vector->size);                                          \
+        return vector->array[index];                                           \
+    }                                                                          \
+                                                                               \
+    static inline T prefix##_front(const struct name *vector) {                \
+        assert(vector->size != 0);                                             \
+        return vector->array[0];                                               \
+    }                                                                          \
+                                                                               \
+    static inline T prefix##_back(const struct name *vector) {                 \
+        assert(vector->size != 0);                                             \
+        return vector->array[vector->size - 1];                                \
+    }                                                                          \
+                                                                               \
+    /* New elements are left uninitialized for the caller to fill. */          \
+    static inline void prefix##_resize_uninitialized(struct name *vector,      \
+                                                     size_t size) {            \
+        if (size > vector->capacity) {                                         \
+            prefix##_grow(vector, size);                                       \
+        }                                                                      \
+        vector->size = size;                                                   \
+    }                                                                          \
+                                                                               \
+    /* `source` may point into the vector itself. */                           \
+    static inline void prefix##_append(struct name *vector, const T *source,   \
+                                       size_t count) {                         \
+        if (count == 0) {                                                      \
+            return;                                                            \
+        }                                                                      \
+        size_t size = xdsa_vector_storage_extend(vector->size, count);         \
+        if (size > vector->capacity) {                                         \
+            bool aliased = xdsa_vector_storage_holds(                          \
+                vector->array, vector->capacity * sizeof(*vector->array),      \
+                source);                                                       \
+            size_t offset = aliased ? (size_t)(source - vector->array) : 0;    \
+            prefix##_grow(vector, size);                                       \
+            if (aliased) {                                                     \
+                source = vector->array + offset;                               \
+            }                                                                  \
+        }                                                                      \
+        memcpy(vector->array + vector->size, source,                           \
+               count * sizeof(*vector->array));                                \
+        XDSA_STATS_ADD(vector->storage.stats, operations, count);              \
+        vector->size += count;                                                 \
+    }                                                                          \
+                                                                               \
+    /* `source` may point into the vector itself; it is read as it was         \
+       before the insertion. */                                                \
+    static inline void prefix##_insert_range(                                  \
+        struct name *vector, size_t index, const T *source, size_t count) {    \
+        assert(index <= vector->size);                                         \
+        if (count == 0) {                                                      \
+            return;                                                            \
+        }                                                                      \
+        /* A source inside the vector moves with the memmove below. */         \
+        T *copy = NULL;                                                        \
+        if (xdsa_vector_storage_holds(                                         \
+                vector->array, vector->capacity * sizeof(*vector->array),      \
+                source)) {                                                     \
+            copy = xdsa_vector_storage_copy(&vector->storage, source,          \
+                                            count * sizeof(*vector->array));   \
+            source = copy;                                                     \
+        }                                                                      \
+        size_t size = xdsa_vector_storage_extend(vector->size, count);         \
+        if (size > vector->capacity) {                                         \
+            prefix##_grow(vector, size);                                       \
+        }                                                                      \
+        memmove(vector->array + index + count, vector->array + index,          \
+                (vector->size - index) * sizeof(*vector->array));              \
+        XDSA_STATS_ADD(vector->storage.stats, bytes_moved,                     \
+                       (vector->size - index) * sizeof(*vector->array));       \
+        XDSA_STATS_ADD(vector->storage.stats, operations, count);              \
+        memcpy(vector->array + index, source,                                  \
+               count * sizeof(*vector->array));                                \
+        xdsa_deallocate(vector->storage.allocator, copy,                       \
+                        count * sizeof(*vector->array));                       \
+        vector->size += count;                                                 \
+    }                                                                          \
+                                                                               \
+    static inline void prefix##_erase_range(struct name *vector, size_t index, \
+                                            size_t count) {                    \
+        assert(index <= vector->size && count <= vector->size - index);        \
+        memmove(vector->array + index, vector->array + index + count,          \
+                (vector->size - index - count) * sizeof(*vector->array));      \
+        XDSA_STATS_ADD(vector->storage.stats, bytes_moved,                     \
+                       (vector->size - index - count) *                        \
+                           sizeof(*vector->array));                            \
+        XDSA_STATS_ADD(vector->storage.stats, operations, count);              \
+        vector->size -= count;                                                 \
+    }
+
+#define XDSA_VECTOR_DEFINE(name, T)                                            \
+    XDSA_VECTOR_STRUCT(name, T);                                               \
+    XDSA_VECTOR_FUNCTIONS(name, name, T)
+
+#define XDSA_SMALL_VECTOR_DEFINE(name, T, N)                                   \
+    struct name {                                                              \
+        XDSA_VECTOR_FIELDS(T)                                                  \
+        T inline_elements[N];                                                  \
+    };                                                                         \
+                                                                               \
+    /* For a vector that the caller owns; pair with `name_deinit`. */          \
+    static inline void name##_init(struct name *vector) {                      \
+        vector->size = 0;                                                      \
+        vector->capacity = (N);                                                \
+        xdsa_vector_storage_init(&vector->storage, NULL, sizeof(*vector));     \
+        vector->array = xdsa_vector_storage_embed(                             \
+            &vector->storage, vector->inline_elements,                         \
+            sizeof(vector->inline_elements));                                  \
+    }                                                                          \
+                                                                               \
+    static inline void name##_deinit(struct name *vector) {                    \
+        xdsa_vector_storage_release(&vector->storage, vector->array,           \
+                                    vector->capacity * sizeof(T));             \
+    }                                                                          \
+                                                                               \
+    XDSA_VECTOR_OPERATIONS(name, name, T)                                      \
+                                                                               \
+    /* Room for max(capacity, N) elements, in one allocation up to N. */       \
+    static inline struct name *name##_create_with_allocator(                   \
+        size_t capacity, const struct xdsa_allocator *allocator) {             \
+        struct name *vector = xdsa_allocate(allocator, sizeof(*vector));       \
+        if (vector == NULL) {                                                  \
+            fprintf(stderr,                                                    \
+                    "Failed to allocate %zu bytes in file %s on line %u "      \
+                    "within function %s.\n",                                   \
+                    sizeof(*vector), __FILE__, __LINE__, __func__);            \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+        name##_init(vector);                                                   \
+        vector->storage.allocator = allocator;                                 \
+        name##_reserve(vector, capacity);                                      \
+        return vector;                                                         \
+    }                                                                          \
+                                                                               \
+    static inline struct name *name##_create(size_t capacity) {                \
+        return name##_create_with_allocator(capacity, NULL);                   \
+    }
+
+// Inline fast paths.
+//
+// Building with `-DXDSA_INLINE` makes the `int` vector and singly linked list
+// structs visible and turns their accessors (size, emptiness, `at`, `front`,
+// `back`, list node traversal) and the vector's `push_back`, `pop_back` and
+// `clear` into `static inline` functions, so a loop over `xdsa_vector_at`
+// compiles to plain loads. Growth stays out of line in `xdsa_vector_grow`.
+// Behaviour and struct layout are the same either way, so translation units
+// built with and without it can be mixed (`XDSA_STATS` must still match);
+// xdsa.c always provides the out-of-line versions.
+struct xdsa_vector;
+
+#if defined(XDSA_INLINE) || defined(XDSA_EXPOSE_LAYOUT)
+struct xdsa_vector {
+    XDSA_VECTOR_FIELDS(int)
+};
+
+struct xdsa_list_node {
+    int data;
+    struct xdsa_list_node *previous;
+    struct xdsa_list_node *next;
+};
+
+struct xdsa_linked_list {
+    size_t size;
+    struct xdsa_list_node *head;
+    struct xdsa_list_node *tail;
+    struct xdsa_list_node_pool *pool;
+#ifdef XDSA_STATS
+    struct xdsa_container_stats stats;
+#endif // XDSA_STATS
+};
+#endif // XDSA_INLINE || XDSA_EXPOSE_LAYOUT
+
+// Slow path of `push_back`: grows to room for at least `minimum` elements.
+extern void xdsa_vector_grow(struct xdsa_vector *vector, size_t minimum);
+
+#ifdef XDSA_INLINE
+static inline int xdsa_vector_size(struct xdsa_vector *vector) {
+    return (int)vector->size;
+}
+
+static inline void xdsa_vector_clear(struct xdsa_vector *vector) {
+    vector->size = 0;
+}
+
+static inline bool xdsa_vector_empty(struct xdsa_vector *vector) {
+    return vector->size == 0;
+}
+
+static inline void xdsa_vector_push_back(struct xdsa_vector *vector,
+                                         int data) {
+    if (vector->size == vector->capacity) {
+        xdsa_vector_grow(vector, vector->size + 1);
+    }
+    XDSA_STATS_ADD(vector->storage.stats, operations, 1);
+    vector->array[vector->size++] = data;
+}
+
+static inline int xdsa_vector_pop_back(struct xdsa_vector *vector) {
+    if (vector->size == 0) {
+        return -1;
+    }
+    XDSA_STATS_ADD(vector->storage.stats, operations, 1);
+    return vector->array[--vector->size];
+}
+
+static inline int xdsa_vector_back(struct xdsa_vector *vector) {
+    return vector->size != 0 ? vector->array[vector->size - 1] : -1;
+}
+
+static inline int xdsa_vector_front(struct xdsa_vector *vector) {
+    return vector->size != 0 ? vector->array[0] : -1;
+}
+
+static inline int xdsa_vector_at(struct xdsa_vector *vector, int index) {
+    if (index < 0 || index >= (int)vector->size) {
+        return -1;
+    }
+    return vector->array[index];
+}
+
+static inline size_t xdsa_vector_capacity(struct xdsa_vector *vector) {
+    return vector->capacity;
+}
+#else
 extern int xdsa_vector_size(struct xdsa_vector *vector);
 extern void xdsa_vector_clear(struct xdsa_vector *vector);
 extern bool xdsa_vector_empty(struct xdsa_vector *vector);
-extern void xdsa_vector_print(struct xdsa_vector *vector);
 extern void xdsa_vector_push_back(struct xdsa_vector *vector, int data);
 extern int xdsa_vector_pop_back(struct xdsa_vector *vector);
 extern int xdsa_vector_back(struct xdsa_vector *vector);
 extern int xdsa_vector_front(struct xdsa_vector *vector);
 extern int xdsa_vector_at(struct xdsa_vector *vector, int index);
 extern size_t xdsa_vector_capacity(struct xdsa_vector *vector);
+#endif // XDSA_INLINE
+
+// FIX: REFACTOR
+extern struct xdsa_vector *xdsa_vector_create(size_t size);
+extern struct xdsa_vector *
+xdsa_vector_create_with_allocator(size_t size,
+                                  const struct xdsa_allocator *allocator);
+// Room for `capacity` elements in the same allocation as the vector.
+extern struct xdsa_vector *xdsa_vector_create_single_block(size_t capacity);
+extern struct xdsa_vector *xdsa_vector_create_single_block_with_allocator(
+    size_t capacity, const struct xdsa_allocator *allocator);
+extern void xdsa_vector_destroy(struct xdsa_vector *vector);
+extern void xdsa_vector_print(struct xdsa_vector *vector);
 extern void xdsa_vector_reserve(struct xdsa_vector *vector, size_t capacity);
+extern void xdsa_vector_set_growth(struct xdsa_vector *vector,
+                                  enum xdsa_vector_growth growth);
+extern void xdsa_vector_shrink_to_fit(struct xdsa_vector *vector);
+extern void xdsa_vector_resize_uninitialized(struct xdsa_vector *vector,
+                                             size_t size);
+extern void xdsa_vector_append(struct xdsa_vector *vector, const int *source,
+                               size_t count);
+extern bool xdsa_vector_insert_range(struct xdsa_vector *vector, size_t index,
+                                     const int *source, size_t count);
+extern bool xdsa_vector_erase_range(struct xdsa_vector *vector, size_t index,
+                                    size_t count);
+extern struct xdsa_container_stats
+xdsa_vector_stats(const struct xdsa_vector *vector);
+
+// Persistence without parsing: `xdsa_vector_save` writes a small versioned
+// header followed by the elements as raw little-endian ints, and
+// `xdsa_vector_open_mmap` maps such a file so the elements are used in place,
+// with no parse or copy step. Both return false/NULL on I/O errors or on a
+// file that is not a saved vector of this version; mapping needs a POSIX,
+// little-endian host. Do not save over a file that is currently mapped.
+//
+// A `XDSA_VECTOR_MAP_READ_WRITE` vector records its size in the file header
+// on `xdsa_vector_sync` (which also flushes the mapping to disk) and on
+// `xdsa_vector_destroy`; sync returns false for every other vector.
+#define XDSA_VECTOR_FILE_VERSION 1
+
+extern bool xdsa_vector_save(struct xdsa_vector *vector, const char *path);
+extern struct xdsa_vector *
+xdsa_vector_open_mmap(const char *path, enum xdsa_vector_map_mode mode);
+extern bool xdsa_vector_sync(struct xdsa_vector *vector);
+
+// Reductions and linear searches over `int` arrays.
+//
+// Each has a scalar, an SSE2 and an AVX2 kernel; the fastest one the CPU
+// supports is picked with CPUID on first use, so one binary runs everywhere.
+// The vector loops use aligned loads and leave the unaligned head and the
+// tail to the scalar kernel. `xdsa_simd_set_level` caps the level (it is
+// clamped to what the CPU supports) and returns the level now in use, which
+// is mostly useful for testing and benchmarking the kernels against each
+// other.
+enum xdsa_simd_level { XDSA_SIMD_SCALAR, XDSA_SIMD_SSE2, XDSA_SIMD_AVX2 };
+
+extern enum xdsa_simd_level xdsa_simd_level(void);
+extern enum xdsa_simd_level xdsa_simd_set_level(enum xdsa_simd_level level);
+
+extern long long xdsa_sum(const int *array, size_t length);
+// False, leaving `min` and `max` alone, when `length` is 0.
+extern bool xdsa_minmax(const int *array, size_t length, int *min, int *max);
+extern size_t xdsa_count_if_eq(const int *array, size_t length, int value);
+// Index of the first element equal to `value`, or `length` if there is none.
+extern size_t xdsa_find(const int *array, size_t length, int value);
+extern bool xdsa_contains(const int *array, size_t length, int value);
+
+extern long long xdsa_vector_sum(const struct xdsa_vector *vector);
+extern bool xdsa_vector_minmax(const struct xdsa_vector *vector, int *min,
+                               int *max);
+extern size_t xdsa_vector_count_if_eq(const struct xdsa_vector *vector,
+                                      int value);
+// Like `xdsa_vector_at`, -1 when there is no such element.
+extern int xdsa_vector_find(const struct xdsa_vector *vector, int value);
+extern bool xdsa_vector_contains(const struct xdsa_vector *vector, int value);
 
 // FIX: REFACTOR
 extern struct xdsa_list_node *xdsa_list_node_create(int data);
 extern void xdsa_list_node_destroy(struct xdsa_list_node *node);
+// A node from `allocator` must be destroyed with the same allocator.
+extern struct xdsa_list_node *
+xdsa_list_node_create_with_allocator(int data,
+                                     const struct xdsa_allocator *allocator);
+extern void
+xdsa_list_node_destroy_with_allocator(struct xdsa_list_node *node,
+                                      const struct xdsa_allocator *allocator);
+
+// Node pool for linked lists.
+//
+// Nodes are carved out of cache-line aligned slabs and recycled through a
+// free list, so pushes and pops do not call `malloc`/`free`. Each list from
+// `xdsa_sll_create` owns a private pool; `xdsa_sll_create_with_pool` lets
+// several lists share one. Clearing or destroying a list hands all of its
+// nodes back to the pool in O(1); the slabs themselves are freed, in
+// O(number of slabs), once the pool's creator and every list using it have
+// let go of it.
+#define XDSA_LIST_SLAB_MIN_NODES 64
+#define XDSA_LIST_SLAB_MAX_NODES 65536
+
+struct xdsa_list_node_pool_stats {
+    size_t slabs;       // slabs currently held
+    size_t slab_bytes;  // bytes held by those slabs
+    size_t acquired;    // nodes handed out
+    size_t recycled;    // nodes handed out from the free list
+    size_t released;    // nodes given back
+    size_t in_use;      // nodes currently handed out
+    size_t peak_in_use; // high-water mark of `in_use`
+};
+
+extern struct xdsa_list_node_pool *
+xdsa_list_node_pool_create(size_t nodes_per_slab);
+extern struct xdsa_list_node_pool *xdsa_list_node_pool_create_with_allocator(
+    size_t nodes_per_slab, const struct xdsa_allocator *allocator);
+extern void xdsa_list_node_pool_destroy(struct xdsa_list_node_pool *pool);
+extern struct xdsa_list_node *
+xdsa_list_node_pool_acquire(struct xdsa_list_node_pool *pool, int data);
+extern void xdsa_list_node_pool_release(struct xdsa_list_node_pool *pool,
+                                        struct xdsa_list_node *node);
+extern struct xdsa_list_node_pool_stats
+xdsa_list_node_pool_stats(const struct xdsa_list_node_pool *pool);
 
 // FIX: REFACTOR
 extern struct xdsa_linked_list *xdsa_sll_create(void);
+// The list and its private pool come from `allocator`; a list created with
+// a shared pool uses the pool's allocator.
+extern struct xdsa_linked_list *
+xdsa_sll_create_with_allocator(const struct xdsa_allocator *allocator);
+extern struct xdsa_linked_list *
+xdsa_sll_create_with_pool(struct xdsa_list_node_pool *pool);
+extern struct xdsa_list_node_pool *xdsa_sll_pool(struct xdsa_linked_list *sll);
 extern void xdsa_sll_destroy(struct xdsa_linked_list *sll);
-extern int xdsa_sll_size(struct xdsa_linked_list *sll);
 extern void xdsa_sll_clear(struct xdsa_linked_list *sll);
-extern bool xdsa_sll_empty(struct xdsa_linked_list *sll);
 extern void xdsa_sll_print(struct xdsa_list_node *head);
 extern void xdsa_sll_push_front(struct xdsa_linked_list *sll, int data);
 extern int xdsa_sll_pop_front(struct xdsa_linked_list *sll);
 extern void xdsa_sll_push_back(struct xdsa_linked_list *sll, int data);
+extern struct xdsa_container_stats
+xdsa_sll_stats(const struct xdsa_linked_list *sll);
+
+// Pushes and pops go through the node pool, whose layout stays private, so
+// only the accessors have inline versions.
+#ifdef XDSA_INLINE
+static inline int xdsa_sll_size(struct xdsa_linked_list *sll) {
+    return (int)sll->size;
+}
+
+static inline bool xdsa_sll_empty(struct xdsa_linked_list *sll) {
+    return sll->size == 0;
+}
+
+static inline int xdsa_sll_front(struct xdsa_linked_list *sll) {
+    return sll->size != 0 ? sll->head->data : -1;
+}
+
+static inline int xdsa_sll_back(struct xdsa_linked_list *sll) {
+    return sll->size != 0 ? sll->tail->data : -1;
+}
+
+static inline struct xdsa_list_node *
+xdsa_sll_head(struct xdsa_linked_list *sll) {
+    return sll->head;
+}
+
+static inline struct xdsa_list_node *
+xdsa_list_node_next(const struct xdsa_list_node *node) {
+    return node->next;
+}
+
+static inline int xdsa_list_node_data(const struct xdsa_list_node *node) {
+    return node->data;
+}
+#else
+extern int xdsa_sll_size(struct xdsa_linked_list *sll);
+extern bool xdsa_sll_empty(struct xdsa_linked_list *sll);
 extern int xdsa_sll_front(struct xdsa_linked_list *sll);
 extern int xdsa_sll_back(struct xdsa_linked_list *sll);
+extern struct xdsa_list_node *xdsa_sll_head(struct xdsa_linked_list *sll);
+extern struct xdsa_list_node *
+xdsa_list_node_next(const struct xdsa_list_node *node);
+extern int xdsa_list_node_data(const struct xdsa_list_node *node);
+#endif // XDSA_INLINE
+
+// Unrolled linked list.
+//
+// Same operations as `xdsa_sll_*` (plus `pop_back`), but each node is a
+// chunk of two whole cache lines, aligned to the first, holding up to
+// `XDSA_UNROLLED_CHUNK_CAPACITY` ints, so traversal touches one pointer per
+// chunk instead of one per element.
+#define XDSA_UNROLLED_CHUNK_BYTES 128
+
+struct xdsa_unrolled_chunk;
+
+// Walks the elements in order:
+//     struct xdsa_ull_iterator it;
+//     for (it = xdsa_ull_begin(list); xdsa_ull_iterator_valid(&it);
+//          xdsa_ull_iterator_next(&it)) {
+//         use(xdsa_ull_iterator_get(&it));
+//     }
+// or a chunk at a time, as plain array loops:
+//     for (it = xdsa_ull_begin(list); xdsa_ull_iterator_valid(&it);
+//          xdsa_ull_iterator_next_chunk(&it)) {
+//         const int *span = xdsa_ull_iterator_span(&it, &length);
+//         ...
+//     }
+struct xdsa_ull_iterator {
+    const struct xdsa_unrolled_chunk *chunk;
+    unsigned int index;
+};
+
+extern struct xdsa_unrolled_list *xdsa_ull_create(void);
+extern struct xdsa_unrolled_list *
+xdsa_ull_create_with_allocator(const struct xdsa_allocator *allocator);
+extern void xdsa_ull_destroy(struct xdsa_unrolled_list *ull);
+extern int xdsa_ull_size(struct xdsa_unrolled_list *ull);
+extern void xdsa_ull_clear(struct xdsa_unrolled_list *ull);
+extern bool xdsa_ull_empty(struct xdsa_unrolled_list *ull);
+extern void xdsa_ull_print(struct xdsa_unrolled_list *ull);
+extern void xdsa_ull_push_front(struct xdsa_unrolled_list *ull, int data);
+extern int xdsa_ull_pop_front(struct xdsa_unrolled_list *ull);
+extern void xdsa_ull_push_back(struct xdsa_unrolled_list *ull, int data);
+extern int xdsa_ull_pop_back(struct xdsa_unrolled_list *ull);
+extern int xdsa_ull_front(struct xdsa_unrolled_list *ull);
+extern int xdsa_ull_back(struct xdsa_unrolled_list *ull);
+extern size_t xdsa_ull_memory_usage(struct xdsa_unrolled_list *ull);
+extern struct xdsa_ull_iterator xdsa_ull_begin(struct xdsa_unrolled_list *ull);
+extern bool xdsa_ull_iterator_valid(const struct xdsa_ull_iterator *iterator);
+extern int xdsa_ull_iterator_get(const struct xdsa_ull_iterator *iterator);
+extern void xdsa_ull_iterator_next(struct xdsa_ull_iterator *iterator);
+extern const int *
+xdsa_ull_iterator_span(const struct xdsa_ull_iterator *iterator,
+                       size_t *length);
+extern void xdsa_ull_iterator_next_chunk(struct xdsa_ull_iterator *iterator);
+
+// Double-ended queue of `int` in a circular array.
+//
+// The capacity is a power of two, so positions wrap with a mask instead of a
+// division. Pushes and pops at either end are O(1) and allocation-free until
+// the array is full; growth doubles it and straightens the wrapped contents
+// out in at most two `memcpy` calls. Like the vector, reads of missing
+// elements return -1.
+struct xdsa_deque;
+
+// `capacity` is rounded up to a power of two; 0 allocates on the first push.
+extern struct xdsa_deque *xdsa_deque_create(size_t capacity);
+extern struct xdsa_deque *
+xdsa_deque_create_with_allocator(size_t capacity,
+                                 const struct xdsa_allocator *allocator);
+extern void xdsa_deque_destroy(struct xdsa_deque *deque);
+extern size_t xdsa_deque_size(const struct xdsa_deque *deque);
+extern size_t xdsa_deque_capacity(const struct xdsa_deque *deque);
+extern bool xdsa_deque_empty(const struct xdsa_deque *deque);
+extern void xdsa_deque_clear(struct xdsa_deque *deque);
+// Grows so `capacity` elements fit without reallocating; never shrinks.
+extern void xdsa_deque_reserve(struct xdsa_deque *deque, size_t capacity);
+extern void xdsa_deque_push_front(struct xdsa_deque *deque, int data);
+extern void xdsa_deque_push_back(struct xdsa_deque *deque, int data);
+extern int xdsa_deque_pop_front(struct xdsa_deque *deque);
+extern int xdsa_deque_pop_back(struct xdsa_deque *deque);
+extern int xdsa_deque_front(const struct xdsa_deque *deque);
+extern int xdsa_deque_back(const struct xdsa_deque *deque);
+// Element `index` counted from the front.
+extern int xdsa_deque_at(const struct xdsa_deque *deque, size_t index);
+extern bool xdsa_deque_set(struct xdsa_deque *deque, size_t index, int data);
+// Pushes `count` elements to the back in order.
+extern void xdsa_deque_append(struct xdsa_deque *deque, const int *source,
+                              size_t count);
+// Copies up to `count` elements starting at `index` into `destination` and
+// returns how many were copied.
+extern size_t xdsa_deque_copy_out(const struct xdsa_deque *deque, size_t index,
+                                  int *destination, size_t count);
+// Like `xdsa_deque_copy_out` from the front, then removes what was copied.
+extern size_t xdsa_deque_pop_front_bulk(struct xdsa_deque *deque,
+                                        int *destination, size_t count);
+
+// Bounded lock-free queues of `int` for handing items between threads.
+//
+// Both are rings with a power-of-two capacity whose producer and consumer
+// indices sit on separate cache lines, so the two sides do not invalidate
+// each other's lines on every operation. Nothing is allocated after create.
+//
+// - `xdsa_spsc_queue`: exactly one producer thread and one consumer thread.
+//   Each side also caches the other's last index and only re-reads it when
+//   the ring looks full (or empty), so most operations touch no shared line.
+// - `xdsa_mpmc_queue`: any number of either (Dmitry Vyukov's bounded queue).
+//   Every slot carries a sequence number saying whose turn it is, and each
+//   side claims positions with one compare-and-swap.
+//
+// `try_push`/`try_pop` never block and return false when the queue is full
+// or empty. The bulk variants move as many items as fit, up to `count`,
+// with one index update (one compare-and-swap for the MPMC queue), and
+// return how many they moved. `size` is a snapshot that may be stale by the
+// time it returns.
+//
+// The library is C99, so the queues use the GCC/Clang `__atomic` builtins,
+// which follow the C11 memory model, and only exist where those do.
+#if defined(__GNUC__)
+#define XDSA_HAVE_ATOMICS 1
+#endif // __GNUC__
+
+#ifdef XDSA_HAVE_ATOMICS
+struct xdsa_spsc_queue;
+struct xdsa_mpmc_queue;
+
+// `capacity` is rounded up to a power of two, at least 2.
+extern struct xdsa_spsc_queue *xdsa_spsc_queue_create(size_t capacity);
+extern void xdsa_spsc_queue_destroy(struct xdsa_spsc_queue *queue);
+extern size_t xdsa_spsc_queue_capacity(const struct xdsa_spsc_queue *queue);
+extern size_t xdsa_spsc_queue_size(const struct xdsa_spsc_queue *queue);
+extern bool xdsa_spsc_queue_try_push(struct xdsa_spsc_queue *queue, int data);
+extern bool xdsa_spsc_queue_try_pop(struct xdsa_spsc_queue *queue, int *data);
+extern size_t xdsa_spsc_queue_push_bulk(struct xdsa_spsc_queue *queue,
+                                        const int *source, size_t count);
+extern size_t xdsa_spsc_queue_pop_bulk(struct xdsa_spsc_queue *queue,
+                                       int *destination, size_t count);
+
+extern struct xdsa_mpmc_queue *xdsa_mpmc_queue_create(size_t capacity);
+extern void xdsa_mpmc_queue_destroy(struct xdsa_mpmc_queue *queue);
+extern size_t xdsa_mpmc_queue_capacity(const struct xdsa_mpmc_queue *queue);
+extern size_t xdsa_mpmc_queue_size(const struct xdsa_mpmc_queue *queue);
+extern bool xdsa_mpmc_queue_try_push(struct xdsa_mpmc_queue *queue, int data);
+extern bool xdsa_mpmc_queue_try_pop(struct xdsa_mpmc_queue *queue, int *data);
+extern size_t xdsa_mpmc_queue_push_bulk(struct xdsa_mpmc_queue *queue,
+                                        const int *source, size_t count);
+extern size_t xdsa_mpmc_queue_pop_bulk(struct xdsa_mpmc_queue *queue,
+                                       int *destination, size_t count);
+#endif // XDSA_HAVE_ATOMICS
+
+// Hash map from `int` keys to `int` values.
+//
+// SwissTable-style flat storage: a control byte per slot holds 7 bits of the
+// key's hash (or "empty"), and lookups compare XDSA_HASHMAP_GROUP control
+// bytes at once (SSE2 where available) before touching any key. Probing is
+// linear, so removal shifts later entries back instead of leaving
+// tombstones and the table never degrades under churn. At most 3/4 of the
+// slots are used before the table doubles; denser linear-probe runs make
+// removals walk too far.
+//
+// Iterate with:
+//     struct xdsa_hashmap_iterator it;
+//     for (it = xdsa_hashmap_begin(map); xdsa_hashmap_iterator_valid(&it);
+//          xdsa_hashmap_iterator_next(&it)) {
+//         use(xdsa_hashmap_iterator_key(&it),
+//             xdsa_hashmap_iterator_value(&it));
+//     }
+// Any insertion or removal invalidates iterators and pointers into the map.
+#define XDSA_HASHMAP_GROUP 16
+
+struct xdsa_hashmap;
+
+struct xdsa_hashmap_iterator {
+    const struct xdsa_hashmap *map;
+    size_t index;
+};
+
+// `capacity` entries fit without rehashing.
+extern struct xdsa_hashmap *xdsa_hashmap_create(size_t capacity);
+extern struct xdsa_hashmap *
+xdsa_hashmap_create_with_allocator(size_t capacity,
+                                   const struct xdsa_allocator *allocator);
+extern void xdsa_hashmap_destroy(struct xdsa_hashmap *map);
+extern size_t xdsa_hashmap_size(const struct xdsa_hashmap *map);
+extern size_t xdsa_hashmap_capacity(const struct xdsa_hashmap *map);
+extern bool xdsa_hashmap_empty(const struct xdsa_hashmap *map);
+extern void xdsa_hashmap_clear(struct xdsa_hashmap *map);
+extern void xdsa_hashmap_reserve(struct xdsa_hashmap *map, size_t capacity);
+// Inserts or overwrites; returns true when `key` was not present before.
+extern bool xdsa_hashmap_put(struct xdsa_hashmap *map, int key, int value);
+extern bool xdsa_hashmap_get(const struct xdsa_hashmap *map, int key,
+                             int *value);
+extern bool xdsa_hashmap_contains(const struct xdsa_hashmap *map, int key);
+// Pointer to the value stored for `key`, or NULL; valid until the next
+// insertion or removal.
+extern int *xdsa_hashmap_find(struct xdsa_hashmap *map, int key);
+extern bool xdsa_hashmap_remove(struct xdsa_hashmap *map, int key);
+extern struct xdsa_hashmap_iterator
+xdsa_hashmap_begin(const struct xdsa_hashmap *map);
+extern bool
+xdsa_hashmap_iterator_valid(const struct xdsa_hashmap_iterator *iterator);
+extern int
+xdsa_hashmap_iterator_key(const struct xdsa_hashmap_iterator *iterator);
+extern int
+xdsa_hashmap_iterator_value(const struct xdsa_hashmap_iterator *iterator);
+extern void xdsa_hashmap_iterator_next(struct xdsa_hashmap_iterator *iterator);
+
+// Binary or 4-ary heap of `int` stored in a `struct xdsa_vector`.
+//
+// `XDSA_HEAP_MIN` keeps the smallest element on top, `XDSA_HEAP_MAX` the
+// largest. A 4-ary heap is half as deep and its children share a cache line,
+// which usually wins once the heap outgrows the cache. Like the vector's,
+// `top` and `pop` return -1 on an empty heap.
+enum xdsa_heap_order { XDSA_HEAP_MIN, XDSA_HEAP_MAX };
+
+struct xdsa_heap;
+
+// `arity` is 2 or 4.
+extern struct xdsa_heap *xdsa_heap_create(enum xdsa_heap_order order,
+                                          unsigned int arity);
+// The heap and its vector come from `allocator`.
+extern struct xdsa_heap *
+xdsa_heap_create_with_allocator(enum xdsa_heap_order order,
+                                unsigned int arity,
+                                const struct xdsa_allocator *allocator);
+// Adopts `vector` (which the heap then destroys) and heapifies it in O(n).
+// The heap shares the vector's allocator.
+extern struct xdsa_heap *
+xdsa_heap_create_from_vector(enum xdsa_heap_order order, unsigned int arity,
+                             struct xdsa_vector *vector);
+extern void xdsa_heap_destroy(struct xdsa_heap *heap);
+extern size_t xdsa_heap_size(const struct xdsa_heap *heap);
+extern bool xdsa_heap_empty(const struct xdsa_heap *heap);
+extern void xdsa_heap_clear(struct xdsa_heap *heap);
+// The backing vector, in heap order, for read-only use.
+extern const struct xdsa_vector *xdsa_heap_vector(const struct xdsa_heap *heap);
+// Replaces the contents with `array` in O(length).
+extern void xdsa_heap_heapify(struct xdsa_heap *heap, const int *array,
+                              size_t length);
+extern void xdsa_heap_push(struct xdsa_heap *heap, int value);
+extern int xdsa_heap_top(const struct xdsa_heap *heap);
+extern int xdsa_heap_pop(struct xdsa_heap *heap);
+// Push then pop with a single sift; returns `value` itself when it would be
+// on top.
+extern int xdsa_heap_push_pop(struct xdsa_heap *heap, int value);
+// Pop then push with a single sift; returns the old top.
+extern int xdsa_heap_replace(struct xdsa_heap *heap, int value);
+// Streaming bound: pushes `value` but keeps at most `limit` elements by
+// dropping the top, so a max-heap retains the `limit` smallest values seen
+// and a min-heap the largest. Returns true if `value` was kept.
+extern bool xdsa_heap_offer(struct xdsa_heap *heap, int value, size_t limit);
+
+// The `k` smallest (ascending) or largest (descending) elements of `array`
+// into `out`, using O(k) memory. Returns how many were written.
+extern size_t xdsa_smallest_k(const int *array, size_t length, size_t k,
+                              int *out);
+extern size_t xdsa_largest_k(const int *array, size_t length, size_t k,
+                             int *out);
 
 // FIX: REFACTOR
 extern void xdsa_insertion_sort(int *array, size_t length);
 
+// Pattern-defeating quicksort: O(n log n) worst case, O(n) on sorted,
+// reversed and many-duplicate inputs. Not stable.
+extern void xdsa_sort(int *array, size_t length);
+
+// LSD radix sort, 8 bits per pass, stable. All four digit histograms come from
+// one read of the input, and passes whose digit is the same for every key are
+// skipped. The `_with_scratch` variants take a caller-owned scratch buffer
+// that grows on demand, so repeated sorts do not allocate; the plain variants
+// allocate a temporary one per call.
+extern struct xdsa_radix_scratch *xdsa_radix_scratch_create(void);
+extern void xdsa_radix_scratch_destroy(struct xdsa_radix_scratch *scratch);
+extern void xdsa_radix_sort(int *array, size_t length);
+extern void xdsa_radix_sort_with_scratch(struct xdsa_radix_scratch *scratch,
+                                         int *array, size_t length);
+// Sorts `keys` and applies the same permutation to `payloads`.
+extern void xdsa_radix_sort_pairs(int *keys, int *payloads, size_t length);
+extern void
+xdsa_radix_sort_pairs_with_scratch(struct xdsa_radix_scratch *scratch,
+                                   int *keys, int *payloads, size_t length);
+
+// Parallel sample sort on pthreads. Splitters drawn from an oversampled set
+// cut the input into about one bucket per thread, plus one bucket for the
+// keys equal to each splitter, so heavy duplicates fill buckets that need no
+// sorting instead of one bucket that a single thread sorts. Threads count,
+// scatter, sort their buckets with `xdsa_sort` and copy back. Every thread
+// gets at least `XDSA_PARALLEL_SORT_CUTOFF` elements, so short inputs take
+// the sequential path. `threads == 0` uses every online CPU. Needs O(length)
+// extra memory.
+#ifndef XDSA_PARALLEL_SORT_CUTOFF
+#define XDSA_PARALLEL_SORT_CUTOFF ((size_t)1 << 16)
+#endif // XDSA_PARALLEL_SORT_CUTOFF
+
+extern void xdsa_parallel_sort(int *array, size_t length, unsigned threads);
+extern void xdsa_vector_parallel_sort(struct xdsa_vector *vector,
+                                      unsigned threads);
+
+// Persistent thread pool for data-parallel loops over `int` arrays.
+//
+// `xdsa_pool_create(threads)` starts `threads - 1` workers that sleep between
+// calls; the calling thread is the last participant. `threads == 0` uses
+// every online CPU. A call cuts its range into chunks of at least the
+// operation's grain and about `XDSA_POOL_CHUNKS_PER_THREAD` per participant,
+// and deals each participant a contiguous run of them. Participants take
+// chunks from the front of their own run and, once it is empty, steal the
+// back half of another's, so uneven chunks still balance. Short inputs run
+// inline on the caller without waking anyone. Calls on one pool are
+// serialized, and callbacks must not call back into the pool that runs
+// them. Reductions and scans keep their per-chunk results in the pool, so
+// repeated calls do not allocate.
+// Without pthreads the pool has one participant and everything runs inline.
+//
+// `xdsa_parallel_for` calls `body(context, chunk, count, offset)` once per
+// chunk, where `chunk == array + offset`. `xdsa_parallel_reduce` folds each
+// chunk with `map` and combines the chunk results with `combine`, from
+// `identity` and in index order, so an associative `combine` gives the same
+// result for any thread count. `xdsa_parallel_inclusive_scan` writes
+// `output[i] = input[0] + ... + input[i]` with two's complement wraparound;
+// it sums every block in a first pass, prefix-sums the block totals, and
+// scans every block from its offset in a second pass. `output` may be
+// `input`.
+#ifndef XDSA_POOL_CHUNKS_PER_THREAD
+#define XDSA_POOL_CHUNKS_PER_THREAD 8
+#endif // XDSA_POOL_CHUNKS_PER_THREAD
+// Minimum chunk length per operation; longer inputs get longer chunks, about
+// XDSA_POOL_CHUNKS_PER_THREAD per participant. The body of a parallel for
+// costs an unknown amount per element, so it gets the smallest chunks.
+// Reductions stream at memory speed and need larger ones to hide the
+// scheduling cost. The scan pays that cost twice per block, once in each
+// pass, so its floor is larger still.
+#ifndef XDSA_PARALLEL_FOR_GRAIN
+#define XDSA_PARALLEL_FOR_GRAIN ((size_t)1 << 12)
+#endif // XDSA_PARALLEL_FOR_GRAIN
+#ifndef XDSA_PARALLEL_REDUCE_GRAIN
+#define XDSA_PARALLEL_REDUCE_GRAIN ((size_t)1 << 14)
+#endif // XDSA_PARALLEL_REDUCE_GRAIN
+#ifndef XDSA_PARALLEL_SCAN_GRAIN
+#define XDSA_PARALLEL_SCAN_GRAIN ((size_t)1 << 15)
+#endif // XDSA_PARALLEL_SCAN_GRAIN
+
+struct xdsa_pool;
+
+extern struct xdsa_pool *xdsa_pool_create(unsigned threads);
+extern void xdsa_pool_destroy(struct xdsa_pool *pool);
+// Participants per call, counting the caller.
+extern unsigned xdsa_pool_threads(const struct xdsa_pool *pool);
+
+extern void xdsa_parallel_for(struct xdsa_pool *pool, int *array,
+                              size_t length,
+                              void (*body)(void *context, int *chunk,
+                                           size_t count, size_t offset),
+                              void *context);
+extern long long
+xdsa_parallel_reduce(struct xdsa_pool *pool, const int *array, size_t length,
+                     long long (*map)(void *context, const int *chunk,
+                                      size_t count),
+                     long long (*combine)(long long a, long long b),
+                     long long identity, void *context);
+extern long long xdsa_parallel_sum(struct xdsa_pool *pool, const int *array,
+                                   size_t length);
+extern void xdsa_parallel_inclusive_scan(struct xdsa_pool *pool,
+                                         const int *input, int *output,
+                                         size_t length);
+
+extern void xdsa_vector_parallel_for(struct xdsa_pool *pool,
+                                     struct xdsa_vector *vector,
+                                     void (*body)(void *context, int *chunk,
+                                                  size_t count, size_t offset),
+                                     void *context);
+extern long long xdsa_vector_parallel_reduce(
+    struct xdsa_pool *pool, const struct xdsa_vector *vector,
+    long long (*map)(void *context, const int *chunk, size_t count),
+    long long (*combine)(long long a, long long b), long long identity,
+    void *context);
+extern long long xdsa_vector_parallel_sum(struct xdsa_pool *pool,
+                                          const struct xdsa_vector *vector);
+// In place.
+extern void xdsa_vector_parallel_inclusive_scan(struct xdsa_pool *pool,
+                                                struct xdsa_vector *vector);
+
 // FIX: REFACTOR
 extern int xdsa_binary_search(const int *array, int length, int target);
 
+// Branchless lower bound over a sorted array: the index of the first element
+// not less than `target`, or `length` if there is none. Prefetches both
+// candidates of the next step so the loop never waits on a mispredict.
+extern size_t xdsa_lower_bound(const int *array, size_t length, int target);
+
+// Looks up `n` targets at once, writing what `xdsa_binary_search` would
+// return for each into `out` (the first match when there are duplicates).
+// Runs XDSA_SEARCH_BATCH_GROUP branchless searches in lock-step so their
+// cache misses overlap instead of stalling one after another.
+#define XDSA_SEARCH_BATCH_GROUP 16
+
+extern void xdsa_binary_search_batch(const int *array, int length,
+                                     const int *targets, int *out, size_t n);
+
+// A read-only copy of a sorted array rearranged for cache-friendly search.
+// The Eytzinger layout stores the implicit binary tree in BFS order; the
+// B-tree layout packs XDSA_SEARCH_BTREE_KEYS keys per cache line so each
+// level costs one miss. Results are indices into the original sorted array.
+enum xdsa_search_layout {
+    XDSA_SEARCH_LAYOUT_EYTZINGER,
+    XDSA_SEARCH_LAYOUT_BTREE,
+};
+
+#define XDSA_SEARCH_BTREE_KEYS 16
+
+struct xdsa_search_index;
+
+extern struct xdsa_search_index *
+xdsa_search_index_create(const int *array, size_t length,
+                         enum xdsa_search_layout layout);
+extern void xdsa_search_index_destroy(struct xdsa_search_index *index);
+extern size_t xdsa_search_index_size(const struct xdsa_search_index *index);
+// Same contract as `xdsa_lower_bound` on the array the index was built from.
+extern size_t
+xdsa_search_index_lower_bound(const struct xdsa_search_index *index,
+                              int target);
+// Index of the first element equal to `target`, or -1 like
+// `xdsa_binary_search`. Returns `int`, so the array must fit in one.
+extern int xdsa_search_index_find(const struct xdsa_search_index *index,
+                                  int target);
+
 // FIX: REFACTOR
 extern unsigned long long int
 xdsa_top_down_fibonacci(unsigned long long int number);
@@ -67,11 +1271,126 @@ extern unsigned long long int
 xdsa_bottom_up_fibonacci(unsigned long long int number);
 
 // FIX: REFACTOR
+extern unsigned long long int
+xdsa_optimized_bottom_up_fibonacci(unsigned long long int number);
+
+// Caller-owned memo table mapping `size_t` keys to results. It grows on
+// demand, and `xdsa_memo_invalidate` forgets every entry in O(1). One memo
+// must not be written from several threads at once, but a frozen memo is
+// read-only and can be shared freely.
+struct xdsa_memo;
+
+extern struct xdsa_memo *xdsa_memo_create(size_t capacity);
+extern void xdsa_memo_destroy(struct xdsa_memo *memo);
+extern size_t xdsa_memo_capacity(const struct xdsa_memo *memo);
+extern bool xdsa_memo_get(const struct xdsa_memo *memo, size_t key,
+                          unsigned long long int *value);
+extern void xdsa_memo_set(struct xdsa_memo *memo, size_t key,
+                          unsigned long long int value);
+extern void xdsa_memo_invalidate(struct xdsa_memo *memo);
+extern void xdsa_memo_freeze(struct xdsa_memo *memo);
+extern bool xdsa_memo_frozen(const struct xdsa_memo *memo);
+
+// Memoize into `memo`, keyed by `number`. A frozen memo is only read; misses
+// fall back to `xdsa_fast_doubling_fibonacci`, as does any `number` past
+// XDSA_FIBONACCI_MAX_EXACT, so the memo never grows beyond that index.
+extern unsigned long long int
+xdsa_top_down_fibonacci_memo(struct xdsa_memo *memo,
+                             unsigned long long int number);
+extern unsigned long long int
+xdsa_bottom_up_fibonacci_memo(struct xdsa_memo *memo,
+                              unsigned long long int number);
+
+// Frozen memo holding F(0) through F(count - 1), to share across threads.
+// `count` is clamped to XDSA_FIBONACCI_MAX_EXACT + 1.
+extern struct xdsa_memo *xdsa_fibonacci_table_create(size_t count);
+
+// Fast doubling: O(log number) multiplications, same indexing as the
+// variants above (F(0) = F(1) = 1). Results past
+// XDSA_FIBONACCI_MAX_EXACT wrap modulo 2^64; use `xdsa_bigint_fibonacci`.
+#define XDSA_FIBONACCI_MAX_EXACT 92
+
+extern unsigned long long int
+xdsa_fast_doubling_fibonacci(unsigned long long int number);
+
+// Non-negative arbitrary-precision integer. Products switch from schoolbook
+// to Karatsuba once both operands reach XDSA_BIGINT_KARATSUBA_LIMBS 32-bit
+// limbs. Results may alias operands.
+#define XDSA_BIGINT_KARATSUBA_LIMBS 32
+
+struct xdsa_bigint;
+
+extern struct xdsa_bigint *xdsa_bigint_create(unsigned long long int value);
+extern void xdsa_bigint_destroy(struct xdsa_bigint *bigint);
+extern void xdsa_bigint_add(struct xdsa_bigint *result,
+                            const struct xdsa_bigint *a,
+                            const struct xdsa_bigint *b);
+extern void xdsa_bigint_multiply(struct xdsa_bigint *result,
+                                 const struct xdsa_bigint *a,
+                                 const struct xdsa_bigint *b);
+extern int xdsa_bigint_compare(const struct xdsa_bigint *a,
+                               const struct xdsa_bigint *b);
+extern size_t xdsa_bigint_bits(const struct xdsa_bigint *bigint);
+// False, leaving `value` untouched, when the number needs more than 64 bits.
+extern bool xdsa_bigint_to_ull(const struct xdsa_bigint *bigint,
+                               unsigned long long int *value);
+// Decimal digits in a malloc'd string the caller frees. Quadratic in the
+// length, so meant for printing rather than hot paths.
+extern char *xdsa_bigint_to_string(const struct xdsa_bigint *bigint);
+// Exact Fibonacci number with the indexing above; F(10^6) has ~209k digits.
+extern struct xdsa_bigint *
+xdsa_bigint_fibonacci(unsigned long long int number);
+
+// Prints the low `size` bits of `number` (two's complement) and a newline.
 extern void xdsa_integer_to_binary(signed long long int number, size_t size);
 
+// Allocation-free formatting into a caller buffer of at least the matching
+// XDSA_FORMAT_*_MAX bytes. Each writes the digits and a terminating NUL and
+// returns the number of digits. `width` is the exact digit count for binary
+// (1-64) and hex (1-16), keeping the low bits of `value`; 0 means as few
+// digits as needed. Hex digits are lowercase.
+#define XDSA_FORMAT_BINARY_MAX 65
+#define XDSA_FORMAT_HEX_MAX 17
+#define XDSA_FORMAT_DECIMAL_MAX 21 // "-9223372036854775808"
+
+extern size_t xdsa_format_binary(char *buffer, unsigned long long int value,
+                                 unsigned int width);
+extern size_t xdsa_format_hex(char *buffer, unsigned long long int value,
+                              unsigned int width);
+extern size_t xdsa_format_decimal(char *buffer, long long int value);
+
+// Writes every element in decimal followed by `separator` (e.g. '\n'), then
+// a NUL, and returns the bytes before the NUL, ready for a single `fwrite`.
+// `buffer` needs XDSA_FORMAT_INT_ARRAY_BYTES(length) bytes.
+#define XDSA_FORMAT_INT_ARRAY_BYTES(length) ((length) * 12 + 1)
+
+extern size_t xdsa_format_int_array(char *buffer, const int *array,
+                                    size_t length, char separator);
+
 // FIX: REFACTOR
 extern int xdsa_mod(long long int a, long long int b);
 
+// A fixed divisor with its reciprocal precomputed, so each reduction is a
+// multiply-high and a correction instead of two divisions. `xdsa_mod_fast`
+// returns exactly what `xdsa_mod(a, divisor)` does, sign of the divisor and
+// zero divisor included. Divisors of magnitude up to 2^31 take the fast
+// path; larger ones fall back to `xdsa_mod`.
+struct xdsa_modulus;
+
+extern struct xdsa_modulus *xdsa_modulus_create(long long int divisor);
+extern struct xdsa_modulus *
+xdsa_modulus_create_with_allocator(long long int divisor,
+                                   const struct xdsa_allocator *allocator);
+extern void xdsa_modulus_destroy(struct xdsa_modulus *modulus);
+extern long long int xdsa_modulus_divisor(const struct xdsa_modulus *modulus);
+extern int xdsa_mod_fast(const struct xdsa_modulus *modulus, long long int a);
+// output[i] = xdsa_mod_fast(modulus, input[i]). The loop is branch-free
+// 64-bit arithmetic on `int` inputs, so the compiler can vectorize it.
+// `input` and `output` may be the same array.
+extern void xdsa_mod_fast_batch(const struct xdsa_modulus *modulus,
+                                const int *input, int *output,
+                                size_t length);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus